@@ -0,0 +1,445 @@
+#include "CompactGraph.h"
+#include "CompressedGraph.h"
+#include "Graph.h"
+#include "GraphLoader.h"
+#include "UndirectedGraph.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+// Benchmarks of the Graph algorithms over every dataset: each benchmark is warmed up, repeated and summarized
+// (min, median, mean and standard deviation of the wall time) next to the result it produced, so a change in speed or
+// in tour quality shows up in the same table.
+
+// A dataset of the data directory
+struct Dataset {
+    std::string group;
+    std::string name;
+    std::string edges;
+    std::string nodes;
+};
+
+// One algorithm under test. run returns the result (tour or tree cost, farthest distance for dijkstra) and the time
+// spent in the measured part, setup work (e.g. the starting tour of 2-opt) is left out
+struct Benchmark {
+    std::string name;
+    bool is_tour;
+    bool needs_complete; // follows edges only, so it fails on sparse graphs
+    int max_vertex;      // skipped on larger datasets unless --full (0 for no limit)
+    std::function<double(Graph &, double &)> run;
+    // used instead of run by the benchmarks of the UndirectedGraph, loaded from the same files
+    std::function<double(const UndirectedGraph &, double &)> run_undirected = nullptr;
+};
+
+// Summary of the repetitions of a benchmark on a dataset
+struct Result {
+    std::string benchmark;
+    std::string dataset;
+    int num_vertex;
+    bool is_tour;
+    std::vector<double> times;
+    double value;
+    double min, median, mean, stddev;
+};
+
+struct Options {
+    std::string data_dir = "../data";
+    unsigned int repetitions = 5;
+    unsigned int warmup = 1;
+    unsigned int two_opt = 3;
+    std::string filter;
+    std::string csv;
+    bool full = false;
+};
+
+static const std::vector<Dataset> DATASETS = {
+    {"toy", "tourism", "Toy-Graphs/tourism.csv", ""},
+    {"toy", "stadiums", "Toy-Graphs/stadiums.csv", ""},
+    {"toy", "shipping", "Toy-Graphs/shipping.csv", ""},
+    {"extra", "edges_25", "Extra_Fully_Connected_Graphs/edges_25.csv", ""},
+    {"extra", "edges_50", "Extra_Fully_Connected_Graphs/edges_50.csv", ""},
+    {"extra", "edges_75", "Extra_Fully_Connected_Graphs/edges_75.csv", ""},
+    {"extra", "edges_100", "Extra_Fully_Connected_Graphs/edges_100.csv", ""},
+    {"extra", "edges_200", "Extra_Fully_Connected_Graphs/edges_200.csv", ""},
+    {"extra", "edges_300", "Extra_Fully_Connected_Graphs/edges_300.csv", ""},
+    {"extra", "edges_400", "Extra_Fully_Connected_Graphs/edges_400.csv", ""},
+    {"extra", "edges_500", "Extra_Fully_Connected_Graphs/edges_500.csv", ""},
+    {"extra", "edges_600", "Extra_Fully_Connected_Graphs/edges_600.csv", ""},
+    {"extra", "edges_700", "Extra_Fully_Connected_Graphs/edges_700.csv", ""},
+    {"extra", "edges_800", "Extra_Fully_Connected_Graphs/edges_800.csv", ""},
+    {"extra", "edges_900", "Extra_Fully_Connected_Graphs/edges_900.csv", ""},
+    {"real", "graph1", "Real-World-Graphs/graph1/edges.csv", "Real-World-Graphs/graph1/nodes.csv"},
+    {"real", "graph2", "Real-World-Graphs/graph2/edges.csv", "Real-World-Graphs/graph2/nodes.csv"},
+    {"real", "graph3", "Real-World-Graphs/graph3/edges.csv", "Real-World-Graphs/graph3/nodes.csv"},
+};
+
+// Cost of a closed tour, infinity if the algorithm did not visit every vertex
+static double tourCost(Graph &graph, const std::vector<Vertex *> &tsp_path) {
+    if (tsp_path.size() != (std::size_t) graph.getNumVertex() + 1) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    double cost = 0;
+    for (std::size_t i = 0; i + 1 < tsp_path.size(); i++) {
+        cost += graph.findDistance(tsp_path[i], tsp_path[i + 1]);
+    }
+    return cost;
+}
+
+// Largest finite distance left in the vertexes by a single source shortest path search
+static double farthestDistance(Graph &graph) {
+    double farthest = 0;
+    for (auto v: graph.getVertexSet()) {
+        if (v.second->getDistance() < std::numeric_limits<double>::max()) {
+            farthest = std::max(farthest, v.second->getDistance());
+        }
+    }
+    return farthest;
+}
+
+static std::vector<Benchmark> benchmarks(const Options &options) {
+    using clock = std::chrono::steady_clock;
+    auto seconds = [](clock::time_point start) {
+        return std::chrono::duration<double>(clock::now() - start).count();
+    };
+
+    unsigned int two_opt = options.two_opt;
+    return {
+        {"dijkstra", false, false, 0, [=](Graph &graph, double &time) {
+            auto start = clock::now();
+            graph.dijkstra(graph.findVertex(0));
+            time = seconds(start);
+            return farthestDistance(graph);
+        }},
+        {"delta-stepping", false, false, 0, [=](Graph &graph, double &time) {
+            // same result as dijkstra; the locality graph it runs on is built once per dataset, by the warmup run
+            auto start = clock::now();
+            graph.deltaStepping(graph.findVertex(0), 0);
+            time = seconds(start);
+            return farthestDistance(graph);
+        }},
+        {"radix-dijkstra", false, false, 0, [=](Graph &graph, double &time) {
+            // weights rounded to hundredths, so the distance can differ from dijkstra's by the rounding along the path
+            const double scale = 100;
+            BasicCompactGraph<int32_t> compact(graph, scale);
+            auto start = clock::now();
+            std::vector<int64_t> dist = radixHeapDijkstra(compact, 0);
+            time = seconds(start);
+            int64_t farthest = 0;
+            for (int64_t d: dist) {
+                if (d != std::numeric_limits<int64_t>::max()) {
+                    farthest = std::max(farthest, d);
+                }
+            }
+            return farthest / scale;
+        }},
+        {"dijkstra-varint", false, false, 0, nullptr, [=](const UndirectedGraph &graph, double &time) {
+            // quantized weights, the distance differs from dijkstra's by at most getMaxError per edge of the path
+            CompressedGraph compressed(graph);
+            auto start = clock::now();
+            std::vector<double> dist = compressed.dijkstra(0);
+            time = seconds(start);
+            double farthest = 0;
+            for (double d: dist) {
+                if (std::isfinite(d)) {
+                    farthest = std::max(farthest, d);
+                }
+            }
+            return farthest;
+        }},
+        {"prim", false, false, 0, [=](Graph &graph, double &time) {
+            std::vector<Vertex *> result;
+            double cost = 0;
+            auto start = clock::now();
+            graph.prim(graph.findVertex(0), result, cost);
+            time = seconds(start);
+            return cost;
+        }},
+        {"triangular-undir", true, false, 0, nullptr, [=](const UndirectedGraph &graph, double &time) {
+            std::vector<int> tour;
+            auto start = clock::now();
+            double cost = graph.triangularApproximation(tour);
+            time = seconds(start);
+            return (int) tour.size() == graph.getNumVertex() ? cost : std::numeric_limits<double>::infinity();
+        }},
+        {"prim-varint", false, false, 0, nullptr, [=](const UndirectedGraph &graph, double &time) {
+            CompressedGraph compressed(graph);
+            std::vector<int> parent;
+            auto start = clock::now();
+            double cost = compressed.prim(0, parent);
+            time = seconds(start);
+            return cost;
+        }},
+        {"bruteforce", true, true, 11, [=](Graph &graph, double &time) {
+            std::vector<Vertex *> tsp_path;
+            auto start = clock::now();
+            graph.tspBruteforce(tsp_path);
+            time = seconds(start);
+            return tourCost(graph, tsp_path);
+        }},
+        {"triangular", true, false, 0, [=](Graph &graph, double &time) {
+            std::vector<Vertex *> tsp_path;
+            auto start = clock::now();
+            graph.triangularApproximation(tsp_path);
+            time = seconds(start);
+            return tourCost(graph, tsp_path);
+        }},
+        {"nearest-neighbor", true, true, 1000, [=](Graph &graph, double &time) {
+            std::vector<Vertex *> tsp_path;
+            auto start = clock::now();
+            graph.tspNearestNeighbor(tsp_path, 0);
+            time = seconds(start);
+            return tourCost(graph, tsp_path);
+        }},
+        {"two-opt", true, true, 1000, [=](Graph &graph, double &time) {
+            std::vector<Vertex *> tsp_path;
+            graph.tspNearestNeighbor(tsp_path, 0);
+            auto start = clock::now();
+            graph.twoOptAlgorithm(tsp_path, two_opt);
+            time = seconds(start);
+            return tourCost(graph, tsp_path);
+        }},
+    };
+}
+
+static void summarize(Result &result) {
+    std::vector<double> sorted = result.times;
+    std::sort(sorted.begin(), sorted.end());
+    std::size_t n = sorted.size();
+
+    result.min = sorted.front();
+    result.median = n % 2 == 1 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+
+    double sum = 0;
+    for (double t: sorted) {
+        sum += t;
+    }
+    result.mean = sum / n;
+
+    double squares = 0;
+    for (double t: sorted) {
+        squares += (t - result.mean) * (t - result.mean);
+    }
+    result.stddev = n > 1 ? std::sqrt(squares / (n - 1)) : 0;
+}
+
+// Gap of a tour to the best tour any benchmark found on the same dataset, in percent
+static double gap(const Result &result, const std::map<std::string, double> &best) {
+    if (!result.is_tour || !std::isfinite(result.value)) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return (result.value / best.at(result.dataset) - 1) * 100;
+}
+
+static void printTable(const std::vector<Result> &results, const std::map<std::string, double> &best) {
+    std::cout << std::left << std::setw(18) << "benchmark" << std::setw(12) << "dataset" << std::right
+              << std::setw(7) << "|V|" << std::setw(6) << "reps" << std::setw(12) << "min(ms)"
+              << std::setw(12) << "median(ms)" << std::setw(12) << "mean(ms)" << std::setw(12) << "stddev(ms)"
+              << std::setw(16) << "result" << std::setw(9) << "gap(%)" << '\n';
+
+    std::cout << std::fixed;
+    for (const Result &r: results) {
+        std::cout << std::left << std::setw(18) << r.benchmark << std::setw(12) << r.dataset << std::right
+                  << std::setw(7) << r.num_vertex << std::setw(6) << r.times.size() << std::setprecision(3)
+                  << std::setw(12) << r.min * 1000 << std::setw(12) << r.median * 1000
+                  << std::setw(12) << r.mean * 1000 << std::setw(12) << r.stddev * 1000 << std::setprecision(2);
+
+        if (std::isfinite(r.value)) {
+            std::cout << std::setw(16) << r.value;
+        } else {
+            std::cout << std::setw(16) << "incomplete";
+        }
+
+        double g = gap(r, best);
+        if (std::isnan(g)) {
+            std::cout << std::setw(9) << "-";
+        } else {
+            std::cout << std::setw(9) << g;
+        }
+        std::cout << '\n';
+    }
+    std::cout << std::defaultfloat;
+}
+
+static bool writeCsv(const std::string &path, const std::vector<Result> &results,
+                     const std::map<std::string, double> &best) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        return false;
+    }
+
+    out << "benchmark,dataset,vertexes,repetitions,min_s,median_s,mean_s,stddev_s,result,gap_percent\n";
+    out << std::setprecision(9);
+    for (const Result &r: results) {
+        double g = gap(r, best);
+        out << r.benchmark << ',' << r.dataset << ',' << r.num_vertex << ',' << r.times.size() << ','
+            << r.min << ',' << r.median << ',' << r.mean << ',' << r.stddev << ',';
+        if (std::isfinite(r.value)) {
+            out << r.value;
+        }
+        out << ',';
+        if (!std::isnan(g)) {
+            out << g;
+        }
+        out << '\n';
+    }
+    return true;
+}
+
+static void printUsage() {
+    std::cout << "Usage: feup_da2_bench [flags]\n"
+              << "  --data DIR          data directory (default ../data)\n"
+              << "  --repetitions N     measured runs of each benchmark (default 5)\n"
+              << "  --warmup N          unmeasured runs before the measured ones (default 1)\n"
+              << "  --two-opt N         2-opt iterations of the two-opt benchmark (default 3)\n"
+              << "  --filter TEXT       only run the benchmark/dataset pairs containing TEXT (e.g. prim, extra, "
+                 "two-opt/edges_900)\n"
+              << "  --csv FILE          also write the results to FILE\n"
+              << "  --full              lift the size limits of the quadratic algorithms (brute force keeps its own)\n";
+}
+
+static bool parse(int argc, char *argv[], Options &options) {
+    for (int i = 1; i < argc; i++) {
+        std::string flag = argv[i];
+        if (flag == "--help") {
+            printUsage();
+            return false;
+        }
+        if (flag == "--full") {
+            options.full = true;
+            continue;
+        }
+        if (i + 1 == argc) {
+            std::cerr << "Missing value for " << flag << '\n';
+            return false;
+        }
+
+        std::string value = argv[++i];
+        try {
+            if (flag == "--data") {
+                options.data_dir = value;
+            } else if (flag == "--repetitions") {
+                options.repetitions = std::max(1ul, std::stoul(value));
+            } else if (flag == "--warmup") {
+                options.warmup = std::stoul(value);
+            } else if (flag == "--two-opt") {
+                options.two_opt = std::stoul(value);
+            } else if (flag == "--filter") {
+                options.filter = value;
+            } else if (flag == "--csv") {
+                options.csv = value;
+            } else {
+                std::cerr << "Unknown flag " << flag << '\n';
+                return false;
+            }
+        } catch (const std::exception &) {
+            std::cerr << "Invalid value for " << flag << ": " << value << '\n';
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+    if (!parse(argc, argv, options)) {
+        return 1;
+    }
+
+    std::vector<Benchmark> suite = benchmarks(options);
+    std::vector<Result> results;
+    std::map<std::string, double> best;
+
+    for (const Dataset &dataset: DATASETS) {
+        std::vector<const Benchmark *> selected;
+        for (const Benchmark &benchmark: suite) {
+            std::string key = benchmark.name + '/' + dataset.group + '/' + dataset.name;
+            if (key.find(options.filter) != std::string::npos) {
+                selected.push_back(&benchmark);
+            }
+        }
+        if (selected.empty()) {
+            continue;
+        }
+
+        std::string nodes = dataset.nodes.empty() ? "" : options.data_dir + '/' + dataset.nodes;
+        Graph graph(!nodes.empty());
+        if (!loader::readGraph(graph, options.data_dir + '/' + dataset.edges, nodes)) {
+            std::cerr << "Skipping " << dataset.name << ": could not read " << options.data_dir << '/'
+                      << dataset.edges << '\n';
+            continue;
+        }
+        int num_vertex = graph.getNumVertex();
+        std::size_t num_edges = 0;
+        for (auto v: graph.getVertexSet()) {
+            num_edges += v.second->getAdj().size();
+        }
+        bool complete = num_edges == (std::size_t) num_vertex * (num_vertex - 1);
+        // loaded on first use, only some benchmarks need it
+        UndirectedGraph undirected;
+        bool undirected_loaded = false;
+
+        for (const Benchmark *benchmark: selected) {
+            if (benchmark->needs_complete && !complete) {
+                continue;
+            }
+            bool limited = benchmark->name == "bruteforce" || !options.full;
+            if (limited && benchmark->max_vertex > 0 && num_vertex > benchmark->max_vertex) {
+                continue;
+            }
+
+            Result result;
+            result.benchmark = benchmark->name;
+            result.dataset = dataset.name;
+            result.num_vertex = num_vertex;
+            result.is_tour = benchmark->is_tour;
+
+            if (benchmark->run_undirected != nullptr && !undirected_loaded) {
+                undirected_loaded = undirected.load(options.data_dir + '/' + dataset.edges, nodes);
+                if (!undirected_loaded) {
+                    continue;
+                }
+            }
+            auto run = [&](double &time) {
+                return benchmark->run_undirected != nullptr ? benchmark->run_undirected(undirected, time)
+                                                            : benchmark->run(graph, time);
+            };
+
+            double time;
+            for (unsigned int i = 0; i < options.warmup; i++) {
+                run(time);
+            }
+            for (unsigned int i = 0; i < options.repetitions; i++) {
+                result.value = run(time);
+                result.times.push_back(time);
+            }
+            summarize(result);
+
+            if (result.is_tour && std::isfinite(result.value)) {
+                auto it = best.find(dataset.name);
+                if (it == best.end() || result.value < it->second) {
+                    best[dataset.name] = result.value;
+                }
+            }
+            results.push_back(result);
+            std::cerr << "done " << result.benchmark << '/' << result.dataset << '\n';
+        }
+    }
+
+    printTable(results, best);
+    if (!options.csv.empty() && !writeCsv(options.csv, results, best)) {
+        std::cerr << "Error writing " << options.csv << '\n';
+        return 1;
+    }
+
+    return 0;
+}
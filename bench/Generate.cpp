@@ -0,0 +1,130 @@
+#include "Generator.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+
+// Command line front end of the generator namespace: writes one synthetic instance, in the csv layout of the datasets
+// (a directory with edges.csv and, for geographic instances, nodes.csv) or as a single binary file.
+
+// Complete graphs above this size would not fit in memory (|V|^2 / 2 edges)
+static const int COMPLETE_LIMIT = 10000;
+
+struct Options {
+    std::string type = "uniform";
+    int num_vertex = 100;
+    uint64_t seed = 1;
+    unsigned int neighbors = 0;
+    unsigned int clusters = 0;
+    std::string format = "csv";
+    std::string output;
+};
+
+static void printUsage() {
+    std::cout << "Usage: feup_da2_gen --output PATH [flags]\n"
+              << "  --type NAME         uniform, clustered, grid (road-like) or geographic (default uniform)\n"
+              << "  --vertexes N        number of vertexes (default 100)\n"
+              << "  --seed S            random seed (default 1)\n"
+              << "  --neighbors K       edges to the K nearest vertexes instead of a complete graph (not grid)\n"
+              << "  --clusters C        centers of a clustered instance (default one per 100 vertexes)\n"
+              << "  --format NAME       csv (PATH is a directory) or binary (PATH is a file) (default csv)\n"
+              << "  --output PATH       where to write the instance\n";
+}
+
+static bool parse(int argc, char *argv[], Options &options) {
+    for (int i = 1; i < argc; i++) {
+        std::string flag = argv[i];
+        if (flag == "--help") {
+            printUsage();
+            return false;
+        }
+        if (i + 1 == argc) {
+            std::cerr << "Missing value for " << flag << '\n';
+            return false;
+        }
+
+        std::string value = argv[++i];
+        try {
+            if (flag == "--type") {
+                options.type = value;
+            } else if (flag == "--vertexes") {
+                options.num_vertex = std::stoi(value);
+            } else if (flag == "--seed") {
+                options.seed = std::stoull(value);
+            } else if (flag == "--neighbors") {
+                options.neighbors = std::stoul(value);
+            } else if (flag == "--clusters") {
+                options.clusters = std::stoul(value);
+            } else if (flag == "--format") {
+                options.format = value;
+            } else if (flag == "--output") {
+                options.output = value;
+            } else {
+                std::cerr << "Unknown flag " << flag << '\n';
+                return false;
+            }
+        } catch (const std::exception &) {
+            std::cerr << "Invalid value for " << flag << ": " << value << '\n';
+            return false;
+        }
+    }
+
+    if (options.type != "uniform" && options.type != "clustered" && options.type != "grid"
+        && options.type != "geographic") {
+        std::cerr << "Unknown instance type " << options.type << '\n';
+        return false;
+    }
+    if (options.format != "csv" && options.format != "binary") {
+        std::cerr << "Unknown format " << options.format << '\n';
+        return false;
+    }
+    if (options.output.empty() || options.num_vertex < 1) {
+        printUsage();
+        return false;
+    }
+    if (options.type != "grid" && options.neighbors == 0 && options.num_vertex > COMPLETE_LIMIT) {
+        std::cerr << "A complete graph of " << options.num_vertex << " vertexes is too large, use --neighbors\n";
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+    if (!parse(argc, argv, options)) {
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    generator::Instance instance;
+    if (options.type == "uniform") {
+        instance = generator::uniform(options.num_vertex, options.seed, options.neighbors);
+    } else if (options.type == "clustered") {
+        instance = generator::clustered(options.num_vertex, options.seed, options.neighbors, options.clusters);
+    } else if (options.type == "grid") {
+        instance = generator::grid(options.num_vertex, options.seed);
+    } else {
+        instance = generator::geographic(options.num_vertex, options.seed, options.neighbors);
+    }
+    std::chrono::duration<double> generated = std::chrono::steady_clock::now() - start;
+
+    bool written;
+    if (options.format == "binary") {
+        written = generator::writeBinary(instance, options.output);
+    } else {
+        mkdir(options.output.c_str(), 0755); // may already exist
+        written = generator::writeCsv(instance, options.output + "/edges.csv", options.output + "/nodes.csv");
+    }
+    std::chrono::duration<double> total = std::chrono::steady_clock::now() - start;
+
+    if (!written) {
+        std::cerr << "Error writing " << options.output << '\n';
+        return 1;
+    }
+
+    std::cout << options.type << ": " << instance.num_vertex << " vertexes, " << instance.getNumEdges()
+              << " edges, generated in " << generated.count() << "s, written in "
+              << (total - generated).count() << "s\n";
+    return 0;
+}
@@ -0,0 +1,67 @@
+#ifndef FEUP_DA2_ALLOCATIONS_H
+#define FEUP_DA2_ALLOCATIONS_H
+
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @brief Heap allocations of each solver phase, counted by replacing the global operator new and operator delete
+ * @details Only compiled in when the project is configured with -DFEUP_DA2_TRACK_ALLOCATIONS=ON, otherwise the
+ * standard allocator is used untouched. Allocations are attributed to the innermost trace span (see Trace.h) of the
+ * allocating thread, or to "(none)" outside of every span, and frees to the span of the freeing thread. Peaks are
+ * high-water marks of the bytes live in the whole process, sampled when a phase allocates.
+ */
+namespace allocation {
+    /**
+     * @brief If the allocation tracking is compiled in
+     */
+#ifdef FEUP_DA2_TRACK_ALLOCATIONS
+    constexpr bool ENABLED = true;
+#else
+    constexpr bool ENABLED = false;
+#endif
+
+    /**
+     * @brief Make a phase the current one of the calling thread (called by the trace spans)
+     *
+     * @param name Name of the phase (must be a string literal or outlive the process)
+     * @return int The phase that was current before, to give back to leavePhase
+     */
+    int enterPhase(const char* name);
+
+    /**
+     * @brief Restore the phase that was current before enterPhase
+     *
+     * @param previous Value returned by enterPhase
+     */
+    void leavePhase(int previous);
+
+    /**
+     * @brief Zero every count and restart the peaks from the bytes live now, call between solves
+     */
+    void reset();
+
+    /**
+     * @brief Get the bytes allocated and not yet freed
+     *
+     * @return uint64_t Live bytes
+     */
+    uint64_t liveBytes();
+
+    /**
+     * @brief Write the phases that allocated or freed since the last reset as a JSON object, e.g.
+     * {"peak_bytes":4096,"phases":{"dijkstra":{"allocations":3,"bytes":1024,"frees":3,"peak_bytes":4096}}}
+     * (an empty object when the tracking is compiled out)
+     *
+     * @param out Stream to write to
+     */
+    void report(std::ostream &out);
+}
+
+#ifdef FEUP_DA2_TRACK_ALLOCATIONS
+#define ALLOCATIONS_RESET() allocation::reset()
+#else
+#define ALLOCATIONS_RESET() ((void) 0)
+#endif
+
+#endif // FEUP_DA2_ALLOCATIONS_H
@@ -0,0 +1,145 @@
+#ifndef FEUP_DA2_BATCH_H
+#define FEUP_DA2_BATCH_H
+
+#include "Graph.h"
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Non-interactive mode: runs a list of TSP jobs given by command line flags (or a jobs file) and writes one JSON
+ * object per job (JSON Lines) with the tour, its cost and the timings
+ * @details Consecutive jobs on the same files reuse the loaded graph.
+ */
+class Batch {
+private:
+    /**
+     * @brief One run of a solver on a dataset
+     */
+    struct Job {
+        std::string edges;
+        std::string nodes;
+        std::string algorithm;
+        unsigned int two_opt = 0;
+        unsigned int threads = 0;
+        double time_limit = 1;
+        double deadline = 0;
+        unsigned int cluster_size = 1000;
+        std::size_t matrix_limit = Graph::DEFAULT_DENSE_MATRIX_LIMIT;
+        int start = 0;
+        std::vector<int> subset;
+    };
+
+    /**
+     * @brief Jobs to run, in order
+     */
+    std::vector<Job> _jobs;
+
+    /**
+     * @brief Path of the results file (empty for the standard output)
+     */
+    std::string _output;
+
+    /**
+     * @brief If the tours are written with the results
+     */
+    bool _write_tour = true;
+
+    /**
+     * @brief Path of the Chrome trace of the run (empty for no trace)
+     */
+    std::string _trace;
+
+    /**
+     * @brief If every solve is measured with the hardware performance counters
+     */
+    bool _perf = false;
+
+    /**
+     * @brief If the jobs are solved concurrently on a SolveService instead of one by one on the Graph
+     */
+    bool _service = false;
+
+    /**
+     * @brief Number of jobs solved at the same time on the SolveService (0 to use every available core)
+     */
+    unsigned int _workers = 0;
+
+    /**
+     * @brief Read the flags of a job
+     *
+     * @param args Flags and their values
+     * @param job Job to fill, keeps its values for the flags not given (output parameter)
+     * @param jobs_file Path given with --jobs, if any (output parameter)
+     * @return true Flags are valid
+     * @return false Unknown flag or missing value (a message is printed)
+     */
+    bool parseFlags(const std::vector<std::string> &args, Job &job, std::string &jobs_file);
+
+    /**
+     * @brief Load the graph of a job, from a binary instance or from the csv files
+     *
+     * @param job Job to load the graph of
+     * @param graph Loaded graph (output parameter)
+     * @return true Graph was loaded
+     * @return false Files could not be read
+     */
+    static bool loadGraph(const Job &job, std::unique_ptr<Graph> &graph);
+
+    /**
+     * @brief Run the solver of a job
+     *
+     * @param graph Graph of the job
+     * @param job Job to run
+     * @param tsp_path The vector to store the TSP path (output parameter)
+     * @param control Deadline of the job, told if the result is optimal
+     * @return double The cost of the TSP path
+     */
+    static double solve(Graph &graph, const Job &job, std::vector<Vertex *> &tsp_path, SolveControl &control);
+
+    /**
+     * @brief Run the jobs one by one with the Graph algorithms, reusing the graph between jobs on the same files
+     *
+     * @param out Stream to write the results to
+     * @return int Exit status (0 if every job succeeded)
+     */
+    int runSequential(std::ostream &out);
+
+    /**
+     * @brief Run the jobs concurrently, each group of consecutive jobs on the same files and matrix limit on one
+     * SolveService (groups on the same files share the loaded graph)
+     *
+     * @param out Stream to write the results to, in the order of the jobs
+     * @return int Exit status (0 if every job succeeded)
+     */
+    int runOnService(std::ostream &out);
+
+public:
+    /**
+     * @brief Read the command line
+     *
+     * @param argc Number of arguments
+     * @param argv Arguments (argv[0] is the program)
+     * @return true Command line is valid
+     * @return false Invalid command line (a message is printed)
+     */
+    bool parse(int argc, char *argv[]);
+
+    /**
+     * @brief Run every job
+     *
+     * @return int Exit status (0 if every job succeeded)
+     */
+    int run();
+
+    /**
+     * @brief Print the available flags and algorithms
+     *
+     * @param out Stream to print to
+     */
+    static void printUsage(std::ostream &out);
+};
+
+#endif // FEUP_DA2_BATCH_H
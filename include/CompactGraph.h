@@ -0,0 +1,162 @@
+#ifndef FEUP_DA2_COMPACTGRAPH_H
+#define FEUP_DA2_COMPACTGRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Graph;
+class ThreadPool;
+
+/**
+ * @brief Read-only copy of the traversal data of a graph packed in flat arrays: adjacency lists in CSR layout and
+ * coordinates as structure of arrays
+ * @details The edges of vertex v are [edgesBegin(v), edgesEnd(v)), vertexes are indexed by their id
+ * (ids must go from 0 to |V| - 1). Only what the shortest path and TSP kernels read is copied, so a 16 byte edge
+ * replaces a heap allocated Edge and its pointer in the adjacency vector.
+ * Instantiated for float, int32_t and double weights (see CompactGraph), integer weights are scaled and rounded.
+ *
+ * @tparam W Weight type
+ */
+template<class W>
+class BasicCompactGraph {
+private:
+    /**
+     * @brief Index of the first edge of each vertex (|V| + 1 entries)
+     */
+    std::vector<int> _offsets;
+
+    /**
+     * @brief Destination of each edge
+     */
+    std::vector<int> _targets;
+
+    /**
+     * @brief Weight of each edge
+     */
+    std::vector<W> _weights;
+
+    /**
+     * @brief Coordinates of each vertex (empty if the graph is not in coordinate mode)
+     */
+    std::vector<double> _longitudes;
+    std::vector<double> _latitudes;
+
+    /**
+     * @brief Id in the original graph of each vertex (empty if the vertexes were not renumbered)
+     */
+    std::vector<int> _original_ids;
+
+public:
+    BasicCompactGraph() = default;
+
+    /**
+     * @brief Packs the edges of a graph
+     * @details Time Complexity: O(|V|+|E|)
+     *
+     * @param graph Graph to copy
+     * @param scale Factor applied to every weight (see weight::convert)
+     */
+    explicit BasicCompactGraph(const Graph &graph, double scale = 1);
+
+    /**
+     * @brief Get the number of vertexes
+     *
+     * @return int Number of vertexes
+     */
+    int getNumVertex() const;
+
+    /**
+     * @brief Get the number of (directed) edges
+     *
+     * @return std::size_t Number of edges
+     */
+    std::size_t getNumEdges() const;
+
+    int edgesBegin(int v) const { return _offsets[v]; }
+
+    int edgesEnd(int v) const { return _offsets[v + 1]; }
+
+    int getTarget(int e) const { return _targets[e]; }
+
+    W getWeight(int e) const { return _weights[e]; }
+
+    /**
+     * @brief If the vertexes have coordinates
+     *
+     * @return true Graph is in coordinate mode
+     * @return false Graph has no coordinates
+     */
+    bool hasCoordinates() const;
+
+    double getLong(int v) const { return _longitudes[v]; }
+
+    double getLat(int v) const { return _latitudes[v]; }
+
+    /**
+     * @brief Calculate the distance between two vertexes using the Haversine formula (needs coordinates)
+     *
+     * @param u First vertex
+     * @param v Second vertex
+     * @return double The distance between the two vertexes
+     */
+    double haversine(int u, int v) const;
+
+    /**
+     * @brief Get the id a vertex had in the original graph
+     *
+     * @param v Vertex index
+     * @return int Original id
+     */
+    int getOriginalId(int v) const { return _original_ids.empty() ? v : _original_ids[v]; }
+
+    /**
+     * @brief Copy the graph with the vertexes renumbered (see the reordering namespace), edges of each vertex sorted
+     * by destination
+     * @details Time Complexity: O(|V| + |E|log(d)) where d is the maximum degree
+     *
+     * @param order Vertex of this graph at each index of the new one
+     * @return BasicCompactGraph Renumbered graph, getOriginalId still gives the ids of the Graph it was built from
+     */
+    BasicCompactGraph permute(const std::vector<int> &order) const;
+
+    /**
+     * @brief Get the memory used by the packed arrays
+     *
+     * @return std::size_t Size in bytes
+     */
+    std::size_t memoryUsage() const;
+
+    /**
+     * @brief Find the minimum cost from source to all other vertexes using parallel delta-stepping.
+     * Tentative distances are grouped in buckets of width delta; the vertexes of the lowest bucket relax their light
+     * edges (weight <= delta) in parallel until the bucket stays empty, then their heavy edges once.
+     * @details Time Complexity: O(|V|+|E|+L) work where L is the number of buckets, spread over the pool threads
+     *
+     * @param source Source vertex
+     * @param delta Bucket width (0 to use the mean edge weight)
+     * @param pool Threads relaxing the edges
+     * @return std::vector<double> Minimum cost to each vertex (infinity if unreachable)
+     */
+    std::vector<double> deltaStepping(int source, double delta, ThreadPool &pool) const;
+};
+
+extern template class BasicCompactGraph<float>;
+extern template class BasicCompactGraph<int32_t>;
+extern template class BasicCompactGraph<double>;
+
+using CompactGraph = BasicCompactGraph<double>;
+
+/**
+ * @brief Find the minimum cost from source to all other vertexes using Dijkstra with a radix heap. Keys only grow, so
+ * each one is kept in the bucket of the highest bit where it differs from the last extracted key and moves down at most
+ * 64 times, instead of paying O(log(|V|)) per heap operation.
+ * @details Time Complexity: O(|E| + |V| * 64)
+ *
+ * @param graph Graph with non negative integer weights
+ * @param source Source vertex
+ * @return std::vector<int64_t> Minimum cost to each vertex (INT64_MAX if unreachable)
+ */
+std::vector<int64_t> radixHeapDijkstra(const BasicCompactGraph<int32_t> &graph, int source);
+
+#endif // FEUP_DA2_COMPACTGRAPH_H
@@ -0,0 +1,148 @@
+#ifndef FEUP_DA2_COMPRESSEDGRAPH_H
+#define FEUP_DA2_COMPRESSEDGRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class UndirectedGraph;
+
+/**
+ * @brief Read-only undirected graph with compressed adjacency lists, for graphs too large for the flat layouts
+ * @details Each vertex owns a block of bytes: its degree, then for every neighbor (in increasing id order) the gap to
+ * the previous neighbor as a varint (7 bits per byte) followed by the weight quantized to 16 bits over the range of all
+ * weights. An edge direction takes 3 to 6 bytes instead of 12 (fewer when neighbors have close ids).
+ * Weights read back differ from the original ones by at most getMaxError(). Vertex ids must go from 0 to |V| - 1.
+ */
+class CompressedGraph {
+private:
+    /**
+     * @brief Encoded adjacency lists
+     */
+    std::vector<uint8_t> _data;
+
+    /**
+     * @brief Offset of the block of each vertex in _data (|V| + 1 entries)
+     */
+    std::vector<uint64_t> _offsets;
+
+    /**
+     * @brief Number of (undirected) edges
+     */
+    std::size_t _num_edges = 0;
+
+    /**
+     * @brief Smallest weight, quantized weight q decodes to _min_weight + q * _step
+     */
+    double _min_weight = 0;
+
+    /**
+     * @brief Difference between consecutive quantized weights
+     */
+    double _step = 0;
+
+    /**
+     * @brief Append a varint to the data
+     *
+     * @param value Value to encode
+     */
+    void writeVarint(uint64_t value);
+
+    /**
+     * @brief Read a varint
+     *
+     * @param pos Position of the first byte, moved past the varint (output parameter)
+     * @return uint64_t Decoded value
+     */
+    uint64_t readVarint(uint64_t &pos) const {
+        uint64_t value = 0;
+        unsigned int shift = 0;
+        uint8_t byte;
+        do {
+            byte = _data[pos++];
+            value |= (uint64_t) (byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        return value;
+    }
+
+public:
+    CompressedGraph() = default;
+
+    /**
+     * @brief Encodes the edges of an undirected graph
+     * @details Time Complexity: O(|V| + |E|log(d)) where d is the maximum degree
+     *
+     * @param graph Graph to compress
+     */
+    explicit CompressedGraph(const UndirectedGraph &graph);
+
+    /**
+     * @brief Get the number of vertexes
+     *
+     * @return int Number of vertexes
+     */
+    int getNumVertex() const;
+
+    /**
+     * @brief Get the number of (undirected) edges
+     *
+     * @return std::size_t Number of edges
+     */
+    std::size_t getNumEdges() const;
+
+    /**
+     * @brief Get the largest difference between a decoded weight and the original one
+     *
+     * @return double Maximum quantization error
+     */
+    double getMaxError() const;
+
+    /**
+     * @brief Decode the neighbors of a vertex
+     * @details Time Complexity: O(deg(v))
+     *
+     * @param v Vertex
+     * @param visit Called with (neighbor, weight) for every neighbor, in increasing neighbor order
+     */
+    template<class F>
+    void forEachNeighbor(int v, F &&visit) const {
+        uint64_t pos = _offsets[v];
+        uint64_t degree = readVarint(pos);
+        uint64_t neighbor = 0;
+        for (uint64_t i = 0; i < degree; i++) {
+            neighbor += readVarint(pos);
+            uint16_t q = (uint16_t) (_data[pos] | (_data[pos + 1] << 8));
+            pos += 2;
+            visit((int) neighbor, _min_weight + q * _step);
+        }
+    }
+
+    /**
+     * @brief Find the minimum cost from source to all other vertexes (Dijkstra over the decoded lists)
+     * @details Time Complexity: O(|V| + |E|log(|V|))
+     *
+     * @param source Source vertex
+     * @return std::vector<double> Minimum cost to each vertex (infinity if unreachable)
+     */
+    std::vector<double> dijkstra(int source) const;
+
+    /**
+     * @brief Minimum Spanning Tree (MST) using Prim's algorithm over the decoded lists
+     * @details Time Complexity: O(|E|log(|V|))
+     *
+     * @param root Root of the tree
+     * @param parent Parent of each vertex in the tree, -1 for the root and unreachable vertexes (output parameter)
+     * @return double Total weight of the tree
+     */
+    double prim(int root, std::vector<int> &parent) const;
+
+    /**
+     * @brief Get the memory used by the encoded lists and their offsets
+     *
+     * @return std::size_t Size in bytes
+     */
+    std::size_t memoryUsage() const;
+};
+
+#endif // FEUP_DA2_COMPRESSEDGRAPH_H
@@ -0,0 +1,185 @@
+#ifndef FEUP_DA2_CONTRACTIONHIERARCHY_H
+#define FEUP_DA2_CONTRACTIONHIERARCHY_H
+
+#include "DistanceMatrix.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Graph;
+
+/**
+ * @brief Contraction hierarchy of a graph, for fast shortest path queries between many pairs of vertexes
+ * @details Vertexes are contracted one by one (least important first), adding shortcut edges so the distances between
+ * the remaining vertexes do not change. A query then only searches upward (towards more important vertexes) from both
+ * ends, settling a few hundred vertexes even on large road graphs. Meant for sparse graphs (Real World Graphs, see
+ * isSparse), vertexes are indexed by their id (ids must go from 0 to |V| - 1).
+ *
+ * Queries reuse internal buffers, so a hierarchy must not be queried from several threads at once.
+ */
+class ContractionHierarchy {
+public:
+    /**
+     * @brief Largest average number of edges per vertex of a graph worth contracting (see isSparse)
+     */
+    static constexpr double MAX_AVERAGE_DEGREE = 16;
+
+private:
+    /**
+     * @brief Number of vertexes
+     */
+    int _size = 0;
+
+    /**
+     * @brief Fingerprint of the graph the hierarchy was built from (see fingerprint)
+     */
+    uint64_t _fingerprint = 0;
+
+    /**
+     * @brief Edges from each vertex to more important ones (forward search), CSR layout
+     */
+    std::vector<int> _fwd_offsets;
+    std::vector<int> _fwd_targets;
+    std::vector<double> _fwd_weights;
+
+    /**
+     * @brief Reversed edges into each vertex from more important ones (backward search), CSR layout
+     */
+    std::vector<int> _bwd_offsets;
+    std::vector<int> _bwd_targets;
+    std::vector<double> _bwd_weights;
+
+    /**
+     * @brief Distance buffers of the searches (infinity when untouched) and the vertexes they touched
+     */
+    std::vector<double> _dist[2];
+    std::vector<int> _touched[2];
+
+    /**
+     * @brief Settle every vertex reachable upward from the source
+     * @details Time Complexity: O(S log(S)) where S is the size of the search space
+     *
+     * @param source Source vertex
+     * @param forward True to follow the forward edges, false the backward ones
+     * @param settled Settled vertexes and their distance (output parameter)
+     */
+    void upwardSearch(int source, bool forward, std::vector<std::pair<int, double>> &settled);
+
+    /**
+     * @brief Reset the distance buffer of a search
+     *
+     * @param side 0 for the forward search, 1 for the backward one
+     */
+    void clearSearch(int side);
+
+public:
+    /**
+     * @brief Constructs an empty hierarchy (see load)
+     */
+    ContractionHierarchy() = default;
+
+    /**
+     * @brief Builds the hierarchy of a graph
+     * @details Vertexes are ordered by edge difference plus contracted neighbors, updated lazily.
+     * Time Complexity: roughly O(|V| * W) where W is the cost of the (bounded) witness searches of one contraction,
+     * on sparse graphs only (see isSparse)
+     *
+     * @param graph Graph to build the hierarchy from
+     */
+    explicit ContractionHierarchy(const Graph &graph);
+
+    /**
+     * @brief Find the minimum cost between two vertexes
+     * @details Time Complexity: O(S log(S)) where S is the size of the upward search spaces
+     *
+     * @param source Source vertex id
+     * @param dest Destination vertex id
+     * @return double The minimum cost (infinity if dest is unreachable)
+     */
+    double query(int source, int dest);
+
+    /**
+     * @brief Find the minimum cost between every source and every target with a bucket based many-to-many search
+     * (one backward search per target and one forward search per source)
+     * @details Time Complexity: O((|sources| + |targets|) * S log(S) + bucket scans)
+     *
+     * @param sources Source vertex ids
+     * @param targets Target vertex ids
+     * @return std::vector<std::vector<double>> Minimum cost from sources[i] to targets[j] at [i][j]
+     */
+    std::vector<std::vector<double>> manyToMany(const std::vector<int> &sources, const std::vector<int> &targets);
+
+    /**
+     * @brief Build the shortest path distance matrix between a set of vertexes (see manyToMany)
+     *
+     * @param vertexes Vertex ids, vertex vertexes[i] becomes index i of the matrix
+     * @return DistanceMatrix Shortest path distances
+     */
+    DistanceMatrix distanceTable(const std::vector<int> &vertexes);
+
+    /**
+     * @brief Write the hierarchy to a binary file
+     *
+     * @param path File path
+     * @return true Hierarchy was saved
+     * @return false File could not be written
+     */
+    bool save(const std::string &path) const;
+
+    /**
+     * @brief Read a hierarchy written by save
+     *
+     * @param path File path
+     * @return true Hierarchy was loaded
+     * @return false File could not be read or is not a hierarchy
+     */
+    bool load(const std::string &path);
+
+    /**
+     * @brief Hash the vertex count and every edge of a graph, so a saved hierarchy can be checked against the graph
+     * it is used with
+     * @details Time Complexity: O(|V| + |E|)
+     *
+     * @param graph Graph to hash
+     * @return uint64_t Fingerprint of the graph
+     */
+    static uint64_t fingerprint(const Graph &graph);
+
+    /**
+     * @brief Check if a graph is sparse enough to contract
+     * @details Every contraction adds shortcuts between the remaining neighbors, so on dense graphs (complete ones in
+     * particular) the remaining graph fills up and the build grows like |V|^5. Those graphs should be queried with
+     * Graph::bidirectionalDijkstra instead.
+     * Time Complexity: O(|V|)
+     *
+     * @param graph Graph to check
+     * @return true Average degree is at most MAX_AVERAGE_DEGREE
+     * @return false Graph is too dense for a hierarchy
+     */
+    static bool isSparse(const Graph &graph);
+
+    /**
+     * @brief Get the fingerprint of the graph the hierarchy was built from
+     *
+     * @return uint64_t Fingerprint (see fingerprint)
+     */
+    uint64_t getFingerprint() const;
+
+    /**
+     * @brief Get the number of vertexes
+     *
+     * @return int Number of vertexes
+     */
+    int getNumVertex() const;
+
+    /**
+     * @brief Get the number of upward edges (original edges and shortcuts)
+     *
+     * @return std::size_t Number of edges
+     */
+    std::size_t getNumEdges() const;
+};
+
+#endif // FEUP_DA2_CONTRACTIONHIERARCHY_H
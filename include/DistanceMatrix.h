@@ -0,0 +1,114 @@
+#ifndef FEUP_DA2_DISTANCEMATRIX_H
+#define FEUP_DA2_DISTANCEMATRIX_H
+
+#include "Weight.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+template<class W> class BasicCompactGraph;
+class Graph;
+class UndirectedGraph;
+
+/**
+ * @brief Dense matrix with the distance between every pair of vertexes, for O(1) weight lookups in the heuristics
+ * @details Uses |V|^2 weights of type W, vertexes are indexed by their id (ids must go from 0 to |V| - 1).
+ * Instantiated for float, int32_t and double (see DistanceMatrix); a float matrix takes half the memory, an int32_t one
+ * stores weights multiplied by a scale and rounded.
+ *
+ * @tparam W Weight type
+ */
+template<class W>
+class BasicDistanceMatrix {
+private:
+    /**
+     * @brief Number of vertexes (rows and columns)
+     */
+    std::size_t _size;
+
+    /**
+     * @brief Row-major distances
+     */
+    std::vector<W> _weights;
+
+public:
+    /**
+     * @brief Constructs a matrix where every vertex is unreachable from the others
+     *
+     * @param size Number of vertexes
+     */
+    explicit BasicDistanceMatrix(std::size_t size);
+
+    /**
+     * @brief Constructs the matrix from the edges of a graph, pairs without an edge get their
+     * haversine distance in Real World Graphs and infinity otherwise
+     * @details Time Complexity: O(|V|^2 + |E|)
+     *
+     * @param graph Graph to read the distances from
+     * @param scale Factor applied to every distance (see weight::convert)
+     */
+    explicit BasicDistanceMatrix(const Graph &graph, double scale = 1);
+
+    /**
+     * @brief Constructs the matrix from a packed graph, same distances as the Graph constructor
+     * @details Time Complexity: O(|V|^2 + |E|)
+     *
+     * @param graph Graph to read the distances from
+     * @param scale Factor applied to every distance (see weight::convert)
+     */
+    explicit BasicDistanceMatrix(const BasicCompactGraph<double> &graph, double scale = 1);
+
+    /**
+     * @brief Constructs the matrix from an undirected graph, same distances as the Graph constructor
+     * @details Time Complexity: O(|V|^2 + |E|)
+     *
+     * @param graph Graph to read the distances from
+     * @param scale Factor applied to every distance (see weight::convert)
+     */
+    explicit BasicDistanceMatrix(const UndirectedGraph &graph, double scale = 1);
+
+    /**
+     * @brief Get the distance between two vertexes
+     *
+     * @param i Source vertex index
+     * @param j Destination vertex index
+     * @return W Distance
+     */
+    W operator()(std::size_t i, std::size_t j) const {
+        return _weights[i * _size + j];
+    }
+
+    /**
+     * @brief Set the distance between two vertexes
+     *
+     * @param i Source vertex index
+     * @param j Destination vertex index
+     * @param weight Distance
+     */
+    void set(std::size_t i, std::size_t j, W weight);
+
+    /**
+     * @brief Get the number of vertexes
+     *
+     * @return std::size_t Number of vertexes
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Calculate the cost of a closed tour
+     * @details Time Complexity: O(n)
+     *
+     * @param tour Vertex indexes in visiting order (without repeating the first one at the end)
+     * @return double Cost of the tour, including the edge back to the start (infinity if an edge is missing)
+     */
+    double tourCost(const std::vector<int> &tour) const;
+};
+
+extern template class BasicDistanceMatrix<float>;
+extern template class BasicDistanceMatrix<int32_t>;
+extern template class BasicDistanceMatrix<double>;
+
+using DistanceMatrix = BasicDistanceMatrix<double>;
+
+#endif // FEUP_DA2_DISTANCEMATRIX_H
@@ -0,0 +1,148 @@
+#ifndef FEUP_DA2_GENERATOR_H
+#define FEUP_DA2_GENERATOR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Seeded synthetic instances for scalability tests (from a few to millions of vertexes)
+ * @details Every instance is an undirected graph over vertexes 0 to |V| - 1. Planar instances (uniform, clustered)
+ * have no coordinates in the output, like the Extra Fully Connected Graphs, while geographic instances (grid,
+ * geographic) carry longitude and latitude, like the Real World Graphs. The same seed always gives the same instance.
+ */
+namespace generator {
+    /**
+     * @brief Generated graph, as edge arrays
+     */
+    struct Instance {
+        /**
+         * @brief Number of vertexes
+         */
+        int num_vertex = 0;
+
+        /**
+         * @brief Coordinates of each vertex (empty for planar instances)
+         */
+        std::vector<double> longitudes;
+        std::vector<double> latitudes;
+
+        /**
+         * @brief Edges, each one stored once
+         */
+        std::vector<int> origins;
+        std::vector<int> dests;
+        std::vector<double> weights;
+
+        /**
+         * @brief If the vertexes have coordinates
+         *
+         * @return true Geographic instance
+         * @return false Planar instance
+         */
+        bool hasCoordinates() const;
+
+        /**
+         * @brief Get the number of edges
+         *
+         * @return std::size_t Number of edges
+         */
+        std::size_t getNumEdges() const;
+    };
+
+    /**
+     * @brief Points uniformly distributed over a 1000x1000 square, weights are euclidean distances
+     * @details Time Complexity: O(|V|^2) complete, O(|V| * k) expected with neighbors
+     *
+     * @param num_vertex Number of vertexes
+     * @param seed Random seed
+     * @param neighbors Edges to the k nearest vertexes of each vertex (0 for a complete graph)
+     * @return Instance Generated instance
+     */
+    Instance uniform(int num_vertex, uint64_t seed, unsigned int neighbors = 0);
+
+    /**
+     * @brief Points normally distributed around random centers of a 1000x1000 square, weights are euclidean distances
+     * @details Time Complexity: O(|V|^2) complete, O(|V| * k) expected with neighbors
+     *
+     * @param num_vertex Number of vertexes
+     * @param seed Random seed
+     * @param neighbors Edges to the k nearest vertexes of each vertex (0 for a complete graph)
+     * @param clusters Number of centers (0 for one per 100 vertexes)
+     * @return Instance Generated instance
+     */
+    Instance clustered(int num_vertex, uint64_t seed, unsigned int neighbors = 0, unsigned int clusters = 0);
+
+    /**
+     * @brief Road-like sparse graph: a jittered street grid (about 100m blocks) with missing streets and a few
+     * diagonals, weights are the haversine distance times a detour factor
+     * @details Rows are always connected, as is the first column, so the graph is connected.
+     * Time Complexity: O(|V|)
+     *
+     * @param num_vertex Number of vertexes
+     * @param seed Random seed
+     * @return Instance Generated instance
+     */
+    Instance grid(int num_vertex, uint64_t seed);
+
+    /**
+     * @brief Points uniformly distributed over the longitude and latitude box of mainland Portugal, weights are
+     * haversine distances
+     * @details Time Complexity: O(|V|^2) complete, O(|V| * k) expected with neighbors
+     *
+     * @param num_vertex Number of vertexes
+     * @param seed Random seed
+     * @param neighbors Edges to the k nearest vertexes of each vertex (0 for a complete graph)
+     * @return Instance Generated instance
+     */
+    Instance geographic(int num_vertex, uint64_t seed, unsigned int neighbors = 0);
+
+    /**
+     * @brief Write an instance in the csv format of the datasets (see loader::readGraph)
+     * @details Time Complexity: O(|V| + |E|)
+     *
+     * @param instance Instance to write
+     * @param edges_file Path of the edges file
+     * @param nodes_file Path of the nodes file (ignored for planar instances)
+     * @return true Files were written
+     * @return false A file could not be written
+     */
+    bool writeCsv(const Instance &instance, const std::string &edges_file, const std::string &nodes_file);
+
+    /**
+     * @brief Write an instance in the binary format: a header (magic, version, flags, |V|, |E|), then the coordinates
+     * (if any) and the origin, destination and weight arrays, in the byte order of the machine
+     * @details Time Complexity: O(|V| + |E|)
+     *
+     * @param instance Instance to write
+     * @param path File path
+     * @return true File was written
+     * @return false File could not be written
+     */
+    bool writeBinary(const Instance &instance, const std::string &path);
+
+    /**
+     * @brief Read the header of a file written by writeBinary
+     *
+     * @param path File path
+     * @param num_vertex Number of vertexes (output parameter)
+     * @param num_edges Number of edges (output parameter)
+     * @param has_coordinates If the vertexes have coordinates (output parameter)
+     * @return true File is a binary instance
+     * @return false File could not be read or is not a binary instance
+     */
+    bool readBinaryHeader(const std::string &path, int &num_vertex, std::size_t &num_edges, bool &has_coordinates);
+
+    /**
+     * @brief Read a file written by writeBinary
+     * @details Time Complexity: O(|V| + |E|)
+     *
+     * @param path File path
+     * @param instance Instance read (output parameter)
+     * @return true File was read
+     * @return false File could not be read, is not a binary instance or is truncated
+     */
+    bool readBinary(const std::string &path, Instance &instance);
+}
+
+#endif // FEUP_DA2_GENERATOR_H
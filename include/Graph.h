@@ -1,8 +1,15 @@
 #ifndef FEUP_DA2_GRAPH_H
 #define FEUP_DA2_GRAPH_H
 
+#include "CompactGraph.h"
+#include "DistanceMatrix.h"
+#include "SolveControl.h"
+#include "TiledDistanceMatrix.h"
 #include "VertexEdge.h"
 
+#include <cstddef>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <unordered_map>
 
@@ -25,16 +32,184 @@ private:
      * @param num_visited The number of vertexes visited
      * @param min_cost The minimum cost found so far
      * @param tsp_path The vector to store the TSP path of the minimum cost (output parameter)
+     * @param control Stops the search early (optional)
      */
-    void tspBacktrackBruteforce(Vertex* current, double current_cost, int num_visited, double& min_cost, std::vector<Vertex *> &tsp_path);
+    void tspBacktrackBruteforce(Vertex* current, double current_cost, int num_visited, double& min_cost,
+                                std::vector<Vertex *> &tsp_path, SolveControl* control);
 
     /**
      * @brief Check if the vertexes have coordinates or not
      * (Used for Real World Graphs)
      */
-    bool _coordinate_mode;
+    bool _coordinate_mode = false;
+
+    /**
+     * @brief Largest factor the haversine distance can be multiplied by while staying below every edge weight,
+     * so the A* heuristic is admissible whatever the units of the weights (negative if not calculated yet)
+     */
+    double _heuristic_scale = -1;
+
+    /**
+     * @brief Packed copy of the graph with the vertexes renumbered for locality (nullptr until used, reset when the
+     * graph changes)
+     */
+    mutable std::unique_ptr<CompactGraph> _locality_graph;
+
+    /**
+     * @brief Guards the construction of _locality_graph, so concurrent readers build it once (replaced with a new flag
+     * when the graph changes, in a unique_ptr so the Graph stays movable)
+     */
+    mutable std::unique_ptr<std::once_flag> _locality_once = std::make_unique<std::once_flag>();
+
+    /**
+     * @brief Drop the locality graph after a change, the next getLocalityGraph builds it again
+     */
+    void resetLocalityGraph();
+
+    /**
+     * @brief If the incomming edges of the vertexes are filled in (see buildIncomming), false when the edges change
+     */
+    bool _incomming_built = false;
+
+    /**
+     * @brief Fill in the incomming edges of every vertex, which addEdge does not keep so they cost no memory unless a
+     * backward search needs them
+     * @details Time Complexity: O(|V| + |E|)
+     */
+    void buildIncomming();
+
+    /**
+     * @brief Get one more than the largest vertex id, the size of the buffers indexed by id
+     * @details Time Complexity: O(|V|)
+     *
+     * @return std::size_t Largest id + 1 (0 if the graph is empty)
+     */
+    std::size_t idBound() const;
+
+    /**
+     * @brief Largest distance matrix (in bytes) ILS and annealing keep in memory, larger ones are tiled on disk
+     */
+    std::size_t _dense_matrix_limit = DEFAULT_DENSE_MATRIX_LIMIT;
+
+    /**
+     * @brief Write the distance matrix of the locality graph to a temporary file and map it
+     * @details Time Complexity: O(|V|^2 + |E|)
+     *
+     * @param dist Matrix to open (output parameter)
+     * @return true Matrix was opened (the file is already removed, the mapping keeps it alive)
+     * @return false Temporary file could not be written
+     */
+    bool openTiledMatrix(TiledDistanceMatrix &dist) const;
+
+    /**
+     * @brief Run 2-opt over nearest neighbor candidates on a tour of locality graph indexes until no move improves it
+     *
+     * @param dist Distances between the locality graph indexes, either kind of matrix
+     * @param tour Tour to improve (output parameter)
+     * @param control Stops the 2-opt early (optional)
+     * @return double Cost of the improved tour
+     */
+    template<class Matrix>
+    double twoOptTour(const Matrix &dist, std::vector<int> &tour, SolveControl* control) const;
+
+    /**
+     * @brief Body of tspIteratedLocalSearch over either kind of distance matrix (indexes of the locality graph)
+     */
+    template<class Matrix>
+    double iteratedLocalSearch(const Matrix &dist, std::vector<Vertex *> &tsp_path, double time_limit,
+                               unsigned int num_threads, SolveControl* control);
+
+    /**
+     * @brief Body of tspSimulatedAnnealing over either kind of distance matrix (indexes of the locality graph)
+     */
+    template<class Matrix>
+    double simulatedAnnealing(const Matrix &dist, std::vector<Vertex *> &tsp_path, double time_limit,
+                              unsigned int num_threads, double &moves_per_second, SolveControl* control);
+
+    /**
+     * @brief Delete a vertex through its actual type (LongLatVertex in coordinate mode, Vertex has no virtual
+     * destructor)
+     *
+     * @param v Vertex to delete
+     */
+    void deleteVertex(Vertex* v);
+
+    /**
+     * @brief Get the packed copy of the graph with the vertexes in locality order (see reordering::localityOrder),
+     * building it if needed. Algorithms work on its dense indexes and map them back with getOriginalId. Safe to call
+     * from several threads at once (e.g. the SolveService workers), as long as none of them changes the graph.
+     * @details Time Complexity: O(|V| + |E|log(d)) the first time, O(1) after
+     *
+     * @return const CompactGraph& Renumbered graph
+     */
+    const CompactGraph& getLocalityGraph() const;
+
+    /**
+     * @brief Map the vertex ids of a tour to the indexes of the locality graph or back
+     *
+     * @param tour Tour to map (modified in place)
+     * @param to_index True to map ids to indexes, false to map indexes to ids
+     */
+    void mapTour(std::vector<int> &tour, bool to_index) const;
+
+    /**
+     * @brief Builds a TSP path from a tour of vertex indexes, starting and ending at vertex 0
+     * @details Time Complexity: O(|V|)
+     *
+     * @param tour Vertex indexes in visiting order (without repeating the first one at the end)
+     * @param tsp_path The vector to store the TSP path (output parameter)
+     */
+    void tourToPath(const std::vector<int> &tour, std::vector<Vertex *> &tsp_path) const;
+
+    /**
+     * @brief Insertion heuristic shared by the cheapest and farthest insertion algorithms
+     * @details Time Complexity: O(|V|^2 log(|V|))
+     *
+     * @param tsp_path The vector to store the TSP path (output parameter)
+     * @param farthest True to insert the vertex farthest from the tour first, false to insert the cheapest one
+     * @return double The cost of the TSP path
+     */
+    double insertionHeuristic(std::vector<Vertex *> &tsp_path, bool farthest);
+
+    /**
+     * @brief Split the vertexes into k clusters with k-means over their coordinates (Real World Graphs)
+     * @details Clusters start as consecutive pieces of the Hilbert curve and each vertex is only compared with the
+     * centroids closest to its current one. Time Complexity: O(I * (|V| + k^2)) where I is the number of iterations
+     *
+     * @param k Number of clusters
+     * @param cluster_order Clusters in the order they should be visited (output parameter)
+     * @return std::vector<int> Cluster of each vertex
+     */
+    std::vector<int> partitionByCoordinates(unsigned int k, std::vector<int> &cluster_order) const;
+
+    /**
+     * @brief Split the vertexes into k clusters around spread seed vertexes, each vertex joins the seed
+     * closest to it by shortest path (multi-source Dijkstra)
+     * @details Clusters are visited in the order of a tour over the shortest path distances between their seeds.
+     * Time Complexity: O(k * (|V| + |E|log(|V|)))
+     *
+     * @param k Number of clusters
+     * @param cluster_order Clusters in the order they should be visited (output parameter)
+     * @return std::vector<int> Cluster of each vertex
+     */
+    std::vector<int> partitionByGraph(unsigned int k, std::vector<int> &cluster_order) const;
+
+    /**
+     * @brief Improve the tour around a position with 2-opt, keeping both ends of the window in place
+     * (a window of the whole tour or more optimizes the whole cycle)
+     * @details Time Complexity: O(W^2 * |E|) where W is the window size
+     *
+     * @param tour Tour of vertex ids (modified in place)
+     * @param position Center of the window
+     * @param window Number of vertexes of the window
+     */
+    void optimizeTourWindow(std::vector<int> &tour, int position, int window) const;
 
 public:
+    /**
+     * @brief Default limit of the in-memory distance matrix, 1 GiB (about 11585 vertexes)
+     */
+    static constexpr std::size_t DEFAULT_DENSE_MATRIX_LIMIT = (std::size_t) 1 << 30;
 
     Graph() = default;
     Graph(bool coordinateMode);
@@ -50,11 +225,11 @@ public:
     Vertex* findVertex(int id) const;
 
     /**
-     * @brief Add a vertex to the graph
+     * @brief Add a vertex to the graph (without coordinates, so not in coordinate mode)
      * 
      * @param int Vertex id
      * @return true Vertex was added
-     * @return false Vertex with that id already exists
+     * @return false Vertex with that id already exists, or the graph is in coordinate mode
      */
     bool addVertex(int id);
 
@@ -100,6 +275,13 @@ public:
      */
     bool addBidirectionalEdge(int source, int dest, double weight);
 
+    /**
+     * @brief Sort the adjacency list of every vertex by destination id (see Vertex::sortAdjacency), called once the
+     * edges are loaded so edge lookups binary search. Lists stay in insertion order until then.
+     * @details Time Complexity: O(|E|log(d)) where d is the maximum degree, O(|V|) if they are already sorted
+     */
+    void sortAdjacency();
+
     /**
      * @brief Find the minimum cost path from source to all other vertexes using Dijkstra algorithm.
      * @details Time Complexity: O(|V|+|E|log(|V|))
@@ -108,14 +290,62 @@ public:
      */
     void dijkstra(Vertex* source);
 
+    /**
+     * @brief Find the minimum cost path from source to all other vertexes using parallel delta-stepping
+     * (see CompactGraph::deltaStepping). Leaves the vertexes in the same state as dijkstra.
+     * @details Time Complexity: O(|V|+|E|+L) work where L is the number of buckets, spread over num_threads threads
+     *
+     * @param source Source vertex
+     * @param delta Bucket width (0 to use the mean edge weight)
+     * @param num_threads Number of threads (0 to use every available core)
+     */
+    void deltaStepping(Vertex* source, double delta, unsigned int num_threads = 0);
+
+    /**
+     * @brief Find the minimum cost between two vertexes using bidirectional Dijkstra, searching forward from
+     * the source (outgoing edges) and backward from the destination (incoming edges) until the searches meet.
+     * Does not change the state of the vertexes, but fills in their incomming edges the first time.
+     * @details Time Complexity: O(|V|+|E|log(|V|)) in the worst case, usually only a fraction of the vertexes are settled
+     *
+     * @param source Source vertex
+     * @param dest Destination vertex
+     * @param settled Number of vertexes settled by the search (optional output parameter)
+     * @return double The minimum cost (infinity if dest is unreachable)
+     */
+    double bidirectionalDijkstra(Vertex* source, Vertex* dest, unsigned int *settled = nullptr);
+
+    /**
+     * @brief Find the minimum cost between two vertexes using A*, guided by the haversine distance to the destination.
+     * Only for graphs with coordinates, does not change the state of the vertexes.
+     * @details Time Complexity: O(|V|+|E|log(|V|)) in the worst case, usually only the vertexes near the straight line
+     * between source and destination are settled
+     *
+     * @param source Source vertex
+     * @param dest Destination vertex
+     * @param settled Number of vertexes settled by the search (optional output parameter)
+     * @return double The minimum cost (infinity if dest is unreachable or the graph has no coordinates)
+     */
+    double aStar(Vertex* source, Vertex* dest, unsigned int *settled = nullptr);
+
+    /**
+     * @brief Find the minimum cost between two vertexes, with A* in Real World Graphs and bidirectional Dijkstra otherwise
+     *
+     * @param source Source vertex
+     * @param dest Destination vertex
+     * @return double The minimum cost (infinity if dest is unreachable)
+     */
+    double shortestPathDistance(Vertex* source, Vertex* dest);
+
     /**
      * @brief Bruteforce algorithm to calculate the TSP path using backtracking
      * @details Time Complexity: O(|V|+|V|!)
      * 
      * @param tsp_path The vector to store the TSP path (output parameter)
-     * @return double The cost of the TSP path
+     * @param control Stops the search early, keeping the best path found so far, and is told if the path is optimal
+     * (optional)
+     * @return double The cost of the TSP path (infinity, with an empty path, if no tour was found)
      */
-    double tspBruteforce(std::vector<Vertex *> &tsp_path);
+    double tspBruteforce(std::vector<Vertex *> &tsp_path, SolveControl* control = nullptr);
 
     /**
      * @brief Minimum Spanning Tree (MST) using Prim's algorithm
@@ -140,6 +370,7 @@ public:
 
     /**
      * @brief Find the weight of an edge
+     * @details Time Complexity: O(log(d)) where d is the degree of the source (see Vertex::getEdge)
      * 
      * @param source Source vertex
      * @param dest Destination vertex
@@ -147,6 +378,17 @@ public:
      */
     double findWeightEdge(int source, int dest);
 
+    /**
+     * @brief Find the distance between two vertexes, the weight of the edge connecting them or,
+     * if there is no such edge, the haversine distance between them (Real World Graphs)
+     * @details Time Complexity: O(|E|) where E are the edges of the source vertex
+     *
+     * @param source Source vertex
+     * @param dest Destination vertex
+     * @return double Distance between the vertexes (infinity if they are not connected and have no coordinates)
+     */
+    double findDistance(Vertex *source, Vertex *dest) const;
+
     /**
      * @brief Calculate the TSP path using the Triangular Approximation Heuristic
      * @details Time Complexity:  O((|V| + |E|)log(|V|) + |V|)
@@ -162,9 +404,10 @@ public:
     * 
     * @param tsp_path The vector to store the TSP path (output parameter)
     * @param two_opt_iterations Number of iterations of the 2-opt algorithm
+    * @param control Stops the 2-opt early, the tour itself is always completed (optional)
     * @return double The cost of the TSP path
     */
-    double tspNearestNeighbor(std::vector<Vertex*>& tsp_path, unsigned int two_opt_iterations);
+    double tspNearestNeighbor(std::vector<Vertex*>& tsp_path, unsigned int two_opt_iterations, SolveControl* control = nullptr);
 
     /**
      * @brief Calculate the TSP path using the 2-opt heuristic
@@ -172,8 +415,97 @@ public:
      * 
      * @param tsp_path The vector to store the TSP path (output parameter)
      * @param two_opt_iterations Number of iterations of the 2-opt algorithm
+     * @param control Stops the improvement early, leaving the path improved so far (optional)
+     */
+    void twoOptAlgorithm(std::vector<Vertex *> &tsp_path, unsigned int two_opt_iterations, SolveControl* control = nullptr);
+
+    /**
+     * @brief Calculate the TSP path by visiting the vertexes in the order of a Hilbert space-filling curve
+     * over their coordinates (with an optional use of 2-opt algorithm)
+     * @details The 2-opt runs over the distances between every pair of vertexes (edge weights, haversine distances
+     * for the missing edges), moving between nearest neighbors until no move improves the tour.
+     * Like ILS and annealing, the distances are tiled on disk when the matrix does not fit in the dense matrix limit.
+     * Time Complexity: O(|V|) to build the tour (curve indexes sorted with a parallel radix sort),
+     * O(|V|^2 log(k)) setup (distance matrix and neighbor lists) plus the 2-opt moves if two_opt is set
+     *
+     * @param tsp_path The vector to store the TSP path (output parameter)
+     * @param two_opt If the tour is improved with 2-opt until no move improves it
+     * @param control Stops the 2-opt early, the tour itself is always completed (optional)
+     * @return double The cost of the TSP path (infinity if the graph has no coordinates or the tiled matrix could not
+     * be written)
+     */
+    double tspHilbertCurve(std::vector<Vertex *> &tsp_path, bool two_opt, SolveControl* control = nullptr);
+
+    /**
+     * @brief Calculate the TSP path using the Cheapest Insertion heuristic, repeatedly inserting the vertex
+     * that increases the tour cost the least in its best position
+     * @details Time Complexity: O(|V|^2 log(|V|)) (best insertion of each vertex kept in an indexed heap; each
+     * vertex also lists its 8 cheapest positions, so an insertion only offers the two new edges to every list and the
+     * whole tour is scanned again only for a vertex whose listed positions were all split)
+     *
+     * @param tsp_path The vector to store the TSP path (output parameter)
+     * @return double The cost of the TSP path
      */
-    void twoOptAlgorithm(std::vector<Vertex *> &tsp_path, unsigned int two_opt_iterations);
+    double tspCheapestInsertion(std::vector<Vertex *> &tsp_path);
+
+    /**
+     * @brief Calculate the TSP path using the Farthest Insertion heuristic, repeatedly inserting the vertex
+     * farthest from the tour in its cheapest position
+     * @details Time Complexity: O(|V|^2 log(|V|))
+     *
+     * @param tsp_path The vector to store the TSP path (output parameter)
+     * @return double The cost of the TSP path
+     */
+    double tspFarthestInsertion(std::vector<Vertex *> &tsp_path);
+
+    /**
+     * @brief Calculate the TSP path using Iterated Local Search, starting from the Nearest Neighbor tour improved with 2-opt
+     * @details The seed tour is built over the distance matrix, so it is complete even on sparse graphs. Each thread
+     * repeatedly perturbs its tour with a double bridge kick, repairs it with 2-opt and keeps the result if it is
+     * cheaper. Threads exchange their best tour periodically until the time limit is reached. Above the dense matrix
+     * limit the distances are read from a TiledDistanceMatrix on disk.
+     * Time Complexity: O(|V|^2 log(|V|)) setup (distance matrix and neighbor lists), then bounded by time_limit
+     *
+     * @param tsp_path The vector to store the TSP path (output parameter)
+     * @param time_limit Time budget in seconds
+     * @param num_threads Number of search threads (0 to use every available core)
+     * @param control Deadline (the earlier of it and time_limit ends the search) and cancellation (optional)
+     * @return double The cost of the TSP path (infinity if the tiled matrix could not be written)
+     */
+    double tspIteratedLocalSearch(std::vector<Vertex *> &tsp_path, double time_limit, unsigned int num_threads = 0,
+                                  SolveControl* control = nullptr);
+
+    /**
+     * @brief Calculate the TSP path using Simulated Annealing (see SimulatedAnnealing), starting from the Nearest Neighbor tour
+     * @details With more than one thread, each thread anneals a replica at a different temperature (parallel tempering).
+     * Above the dense matrix limit the distances are read from a TiledDistanceMatrix on disk.
+     * Time Complexity: O(|V|^2 log(|V|)) setup (distance matrix and neighbor lists), then bounded by time_limit
+     *
+     * @param tsp_path The vector to store the TSP path (output parameter)
+     * @param time_limit Time budget in seconds
+     * @param num_threads Number of replicas/threads (0 to use every available core)
+     * @param moves_per_second Throughput of the annealing, moves evaluated per second (output parameter)
+     * @param control Deadline (the earlier of it and time_limit ends the annealing) and cancellation (optional)
+     * @return double The cost of the TSP path (infinity if the tiled matrix could not be written)
+     */
+    double tspSimulatedAnnealing(std::vector<Vertex *> &tsp_path, double time_limit, unsigned int num_threads,
+                                 double &moves_per_second, SolveControl* control = nullptr);
+
+    /**
+     * @brief Calculate the TSP path by clustering the vertexes first and routing each cluster second
+     * @details Vertexes are split with k-means over their coordinates (Real World Graphs) or around seed vertexes by
+     * shortest path (other graphs). Each cluster is solved in parallel with Nearest Neighbor and 2-opt, the cluster tours
+     * are opened at their cheapest edge and chained, and 2-opt is run again around every junction.
+     * Time Complexity: O(|V| * S + |E|) where S is the cluster size, so only S^2 distances are ever stored per cluster
+     *
+     * @param tsp_path The vector to store the TSP path (output parameter)
+     * @param cluster_size Approximate number of vertexes per cluster
+     * @param num_threads Number of threads solving clusters (0 to use every available core)
+     * @param control Stops the 2-opt of the clusters and of the junctions early, every cluster is still routed (optional)
+     * @return double The cost of the TSP path
+     */
+    double tspClusterDecomposition(std::vector<Vertex *> &tsp_path, unsigned int cluster_size, unsigned int num_threads = 0,
+                                   SolveControl* control = nullptr);
 
     /**
      * @brief Get graph's number of vertexes
@@ -182,6 +514,36 @@ public:
      */
     int getNumVertex() const;
 
+    /**
+     * @brief If the vertexes of the graph have coordinates
+     *
+     * @return true Graph is a Real World Graph
+     * @return false Graph has no coordinates
+     */
+    bool isCoordinateMode() const;
+
+    /**
+     * @brief Set the largest distance matrix ILS and annealing keep in memory
+     *
+     * @param bytes Limit in bytes (0 to always use the tiled matrix)
+     */
+    void setDenseMatrixLimit(std::size_t bytes);
+
+    /**
+     * @brief Get the largest distance matrix ILS and annealing keep in memory
+     *
+     * @return std::size_t Limit in bytes
+     */
+    std::size_t getDenseMatrixLimit() const;
+
+    /**
+     * @brief If the |V|^2 distance matrix of the graph fits in the dense matrix limit
+     *
+     * @return true The matrix is kept in memory
+     * @return false The matrix is tiled on disk
+     */
+    bool fitsDenseMatrix() const;
+
     /**
      * @brief Get graph's vertexes
      * 
@@ -0,0 +1,47 @@
+#ifndef FEUP_DA2_GRAPHLOADER_H
+#define FEUP_DA2_GRAPHLOADER_H
+
+#include "Generator.h"
+#include "Graph.h"
+
+#include <string>
+
+namespace loader {
+    /**
+     * @brief Read the csv files of a dataset into a graph (a header line, then origin,destination,distance edges and
+     * id,longitude,latitude nodes), every edge is added in both directions and the adjacency lists are sorted once at
+     * the end (see Graph::sortAdjacency)
+     * @details Time Complexity: O(|V| + |E|log(d)) where d is the maximum degree
+     *
+     * @param graph Empty graph to fill, in coordinate mode if a nodes file is given
+     * @param edges_file Path of the edges file
+     * @param nodes_file Path of the nodes file (empty for graphs without coordinates)
+     * @return true Graph was read
+     * @return false A file could not be opened or has a field that is not a number
+     */
+    bool readGraph(Graph &graph, const std::string &edges_file, const std::string &nodes_file = "");
+
+    /**
+     * @brief Read an instance written by generator::writeBinary into a graph, every edge is added in both directions
+     * @details Time Complexity: O(|V| + |E|log(d)) where d is the maximum degree
+     *
+     * @param graph Empty graph to fill, the coordinates are only read if it is in coordinate mode
+     * @param path Path of the binary file
+     * @return true Graph was read
+     * @return false File could not be read or is not a binary instance
+     */
+    bool readBinaryGraph(Graph &graph, const std::string &path);
+
+    /**
+     * @brief Fill a graph with a generated instance, every edge is added in both directions
+     * @details Time Complexity: O(|V| + |E|log(d)) where d is the maximum degree
+     *
+     * @param graph Empty graph to fill, the coordinates are only used if it is in coordinate mode
+     * @param instance Instance to copy
+     * @return true Graph was filled
+     * @return false The graph is in coordinate mode but the instance has no coordinates
+     */
+    bool buildGraph(Graph &graph, const generator::Instance &instance);
+}
+
+#endif // FEUP_DA2_GRAPHLOADER_H
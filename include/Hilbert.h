@@ -0,0 +1,44 @@
+#ifndef FEUP_DA2_HILBERT_H
+#define FEUP_DA2_HILBERT_H
+
+#include <cstdint>
+#include <vector>
+
+namespace hilbert {
+    /**
+     * @brief Number of bits used per axis when mapping coordinates to the curve grid
+     */
+    constexpr unsigned int ORDER = 16;
+
+    /**
+     * @brief Calculate the position of a grid cell along the Hilbert curve
+     * @details Time Complexity: O(ORDER)
+     *
+     * @param x Cell column (in [0, 2^ORDER))
+     * @param y Cell row (in [0, 2^ORDER))
+     * @return uint32_t Distance of the cell from the beginning of the curve
+     */
+    uint32_t index(uint32_t x, uint32_t y);
+
+    /**
+     * @brief Map points to their Hilbert curve index, scaling them to the bounding box of all points
+     * @details Time Complexity: O(n * ORDER)
+     *
+     * @param xs X coordinate of each point (e.g. longitude)
+     * @param ys Y coordinate of each point (e.g. latitude)
+     * @return std::vector<uint32_t> Curve index of each point
+     */
+    std::vector<uint32_t> indexes(const std::vector<double> &xs, const std::vector<double> &ys);
+
+    /**
+     * @brief Sort values by their keys using a parallel LSD radix sort (8 bits per pass)
+     * @details Time Complexity: O(n) work, O(n / num_threads) per thread
+     *
+     * @param keys Keys to sort by (sorted in place)
+     * @param values Values attached to each key (permuted along with the keys)
+     * @param num_threads Number of threads to use (0 to use every available core)
+     */
+    void radixSort(std::vector<uint32_t> &keys, std::vector<int> &values, unsigned int num_threads = 0);
+}
+
+#endif // FEUP_DA2_HILBERT_H
@@ -0,0 +1,124 @@
+#ifndef FEUP_DA2_INSTRUMENTATION_H
+#define FEUP_DA2_INSTRUMENTATION_H
+
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @brief Hot path counters and per-phase wall time, reported at the end of a solve
+ * @details The INSTRUMENT_* macros expand to nothing unless the project is configured with
+ * -DFEUP_DA2_INSTRUMENT=ON, so the algorithms pay nothing for them in normal builds. Counters are per thread (no
+ * atomics in the hot paths) and are summed, including the ones of threads that already finished, when reported.
+ * Phases are the trace spans (see Trace.h), summed by name.
+ */
+namespace instrument {
+    /**
+     * @brief If the instrumentation is compiled in
+     */
+#ifdef FEUP_DA2_INSTRUMENT
+    constexpr bool ENABLED = true;
+#else
+    constexpr bool ENABLED = false;
+#endif
+
+    /**
+     * @brief Events counted
+     */
+    enum Counter {
+        DIJKSTRA_PUSHES,
+        DIJKSTRA_RELAXATIONS,
+        QUEUE_INSERTS,
+        QUEUE_DECREASE_KEYS,
+        QUEUE_EXTRACT_MINS,
+        GET_EDGE_CALLS,
+        GET_EDGE_PROBES,
+        HAVERSINE_CALLS,
+        TWO_OPT_EVALUATED,
+        TWO_OPT_APPLIED,
+        BRUTEFORCE_NODES,
+        BRUTEFORCE_LEAVES,
+        NUM_COUNTERS
+    };
+
+    /**
+     * @brief Counters of one thread, registered while the thread lives
+     */
+    struct ThreadCounters {
+        uint64_t values[NUM_COUNTERS] = {};
+
+        ThreadCounters();
+        ~ThreadCounters();
+    };
+
+    /**
+     * @brief Counters of the calling thread
+     */
+    inline thread_local ThreadCounters thread_counters;
+
+    /**
+     * @brief Increment a counter of the calling thread
+     *
+     * @param counter Counter to increment
+     * @param amount Amount to add
+     */
+    inline void count(Counter counter, uint64_t amount = 1) {
+        thread_counters.values[counter] += amount;
+    }
+
+    /**
+     * @brief Number of elements a binary search over n elements looks at
+     *
+     * @param n Number of elements
+     * @return uint64_t ceil(log2(n + 1))
+     */
+    inline uint64_t binarySearchProbes(uint64_t n) {
+        uint64_t probes = 0;
+        while (n > 0) {
+            n >>= 1;
+            probes++;
+        }
+        return probes;
+    }
+
+    /**
+     * @brief Add wall time to a phase (called by the trace spans in instrumented builds)
+     *
+     * @param name Name of the phase
+     * @param seconds Time spent
+     */
+    void addPhase(const char* name, double seconds);
+
+    /**
+     * @brief Zero every counter and phase, call between solves (not while other threads are counting)
+     */
+    void reset();
+
+    /**
+     * @brief Get the total of a counter over every thread since the last reset
+     *
+     * @param counter Counter to read
+     * @return uint64_t Total
+     */
+    uint64_t total(Counter counter);
+
+    /**
+     * @brief Write the counters that are not zero and the phases as a JSON object, e.g.
+     * {"counters":{"dijkstra_pushes":12},"phases":{"dijkstra":{"seconds":0.01,"calls":1}}}
+     * (an empty object when the instrumentation is compiled out)
+     *
+     * @param out Stream to write to
+     */
+    void report(std::ostream &out);
+}
+
+#ifdef FEUP_DA2_INSTRUMENT
+#define INSTRUMENT_COUNT(counter) instrument::count(instrument::counter)
+#define INSTRUMENT_ADD(counter, amount) instrument::count(instrument::counter, (amount))
+#define INSTRUMENT_RESET() instrument::reset()
+#else
+#define INSTRUMENT_COUNT(counter) ((void) 0)
+#define INSTRUMENT_ADD(counter, amount) ((void) 0)
+#define INSTRUMENT_RESET() ((void) 0)
+#endif
+
+#endif // FEUP_DA2_INSTRUMENTATION_H
@@ -0,0 +1,115 @@
+#ifndef FEUP_DA2_LOCALSEARCH_H
+#define FEUP_DA2_LOCALSEARCH_H
+
+#include "DistanceMatrix.h"
+#include "SolveControl.h"
+#include "TiledDistanceMatrix.h"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Local search kernels working on tours of vertex indexes
+ * @details Tours never repeat the first vertex at the end. The kernels taking distances are templates over the matrix
+ * type (anything with size() and operator()(i, j)), explicitly instantiated in LocalSearch.cpp for the DistanceMatrix
+ * weight types and TiledDistanceMatrix.
+ */
+namespace localsearch {
+    /**
+     * @brief Small and fast xorshift random number generator, one per thread
+     */
+    class Random {
+    private:
+        uint64_t _state;
+
+    public:
+        explicit Random(uint64_t seed);
+
+        /**
+         * @brief Get the next random number
+         *
+         * @return uint64_t Random number
+         */
+        uint64_t next();
+
+        /**
+         * @brief Get a random number in [0, bound)
+         *
+         * @param bound Upper bound (exclusive)
+         * @return uint32_t Random number
+         */
+        uint32_t below(uint32_t bound);
+
+        /**
+         * @brief Get a random number in [0, 1)
+         *
+         * @return double Random number
+         */
+        double uniform();
+    };
+
+    /**
+     * @brief Calculate the k nearest neighbors of every vertex, the candidates of the 2-opt moves
+     * @details Time Complexity: O(n^2 log(k))
+     *
+     * @param dist Distances between vertexes
+     * @param k Number of neighbors per vertex
+     * @return std::vector<std::vector<int>> Neighbors of each vertex sorted by distance
+     */
+    template<class Matrix>
+    std::vector<std::vector<int>> nearestNeighbors(const Matrix &dist, unsigned int k);
+
+    /**
+     * @brief Build a tour by always moving to the closest unvisited vertex
+     * @details Time Complexity: O(n^2)
+     *
+     * @param dist Distances between vertexes
+     * @param start First vertex of the tour
+     * @return std::vector<int> Tour
+     */
+    template<class Matrix>
+    std::vector<int> nearestNeighborTour(const Matrix &dist, int start);
+
+    /**
+     * @brief Reverse the tour between two positions (going forward, wrapping around the end),
+     * or the complementary part of the tour if it is shorter (both give the same cycle)
+     * @details Time Complexity: O(min(len, n - len))
+     *
+     * @param tour Tour to change (modified in place)
+     * @param pos Position of each vertex in the tour (kept up to date)
+     * @param i First position of the segment
+     * @param j Last position of the segment
+     */
+    void reverse(std::vector<int> &tour, std::vector<int> &pos, int i, int j);
+
+    /**
+     * @brief Improve the tour with 2-opt moves until no move between neighbors improves it,
+     * using don't look bits so only vertexes near a change are revisited
+     * @details Time Complexity: O(n * k) per pass, plus the segment reversals (at most n / 2 each)
+     *
+     * @param tour Tour to improve (modified in place)
+     * @param dist Distances between vertexes
+     * @param neighbors Candidate neighbors of each vertex (see nearestNeighbors)
+     * @param active Vertexes to start looking at (empty to look at all of them)
+     * @param control Stops the search early, leaving the tour improved so far (optional)
+     * @return double Change in the tour cost (zero or negative)
+     */
+    template<class Matrix>
+    double twoOpt(std::vector<int> &tour, const Matrix &dist, const std::vector<std::vector<int>> &neighbors,
+                  const std::vector<int> &active = {}, SolveControl* control = nullptr);
+
+    /**
+     * @brief Perturb the tour with a double bridge move (A B C D -> A C B D) inside a random window
+     * @details Time Complexity: O(n)
+     *
+     * @param tour Tour to perturb (modified in place, needs at least 8 vertexes)
+     * @param dist Distances between vertexes
+     * @param rng Random number generator
+     * @param endpoints Vertexes at the ends of the changed edges (output parameter)
+     * @return double Change in the tour cost
+     */
+    template<class Matrix>
+    double doubleBridge(std::vector<int> &tour, const Matrix &dist, Random &rng, std::vector<int> &endpoints);
+}
+
+#endif // FEUP_DA2_LOCALSEARCH_H
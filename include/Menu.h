@@ -2,7 +2,9 @@
 #define FEUP_DA2_MENU_H
 
 #include "Graph.h"
+#include "SolveControl.h"
 
+#include <functional>
 #include <string>
 
 /**
@@ -33,6 +35,18 @@ private:
      */
     void readData(bool coordinateMode);
 
+    /**
+     * @brief Run a solver on a worker thread, showing its progress (best cost and work per second) until it ends
+     * @details On a terminal, pressing Enter cancels the solve through its control and the solver returns the best
+     * tour it has so far. Solvers without a control only show the elapsed time.
+     *
+     * @param solve Solver to run
+     * @param work_unit Name of the work the solver reports, e.g. "nodes" (nullptr if it takes no control)
+     * @param control Control given to the solver
+     * @return double The cost returned by the solver
+     */
+    static double runSolver(const std::function<double()> &solve, const char* work_unit, SolveControl &control);
+
     /**
      * @brief Calculate the Traveling Salesman Problem (TSP) using the brute force algorithm.
      */
@@ -48,6 +62,40 @@ private:
      */
     void calculateNearestNeighborTSP();
 
+    /**
+     * @brief Calculate the Traveling Salesman Problem (TSP) by following a Hilbert curve over the vertexes coordinates.
+     */
+    void calculateHilbertCurveTSP();
+
+    /**
+     * @brief Calculate the Traveling Salesman Problem (TSP) using an insertion heuristic.
+     *
+     * @param farthest True to use Farthest Insertion, false to use Cheapest Insertion
+     */
+    void calculateInsertionTSP(bool farthest);
+
+    /**
+     * @brief Calculate the Traveling Salesman Problem (TSP) using Iterated Local Search on top of the Nearest Neighbor tour.
+     */
+    void calculateIteratedLocalSearchTSP();
+
+    /**
+     * @brief Calculate the Traveling Salesman Problem (TSP) using Simulated Annealing on top of the Nearest Neighbor tour.
+     */
+    void calculateSimulatedAnnealingTSP();
+
+    /**
+     * @brief Calculate the Traveling Salesman Problem (TSP) by clustering the vertexes and solving each cluster in parallel.
+     */
+    void calculateClusterDecompositionTSP();
+
+    /**
+     * @brief Calculate the shortest path between two vertexes with a Contraction Hierarchy.
+     * The hierarchy is saved in the cache directory (~/.cache/feup_da2) under the fingerprint of the graph, so it is
+     * only built once per dataset and rebuilt when the edges change.
+     */
+    void calculateShortestPath();
+
     /**
      * @brief Display the graph selection menu.
      */
@@ -1,40 +1,77 @@
 #ifndef FEUP_DA2_MUTABLEPRIORITYQUEUE
 #define FEUP_DA2_MUTABLEPRIORITYQUEUE
 
+#include "Instrumentation.h"
+
 #include <vector>
 
+/**
+ * @brief Default ordering of the queue, compares the pointed elements with their operator<
+ */
 template <class T>
+struct DereferenceLess {
+    bool operator()(T * a, T * b) const {
+        return *a < *b;
+    }
+};
+
+/**
+ * @brief Indexed binary heap of pointers, each element keeps its position in the heap in a queueIndex field
+ * (0 when it is not in the queue) so its key can be updated in O(log n)
+ *
+ * @tparam T Element type (must have a public queueIndex field)
+ * @tparam Compare Strict ordering of the elements, the smallest one is at the top
+ */
+template <class T, class Compare = DereferenceLess<T>>
 class MutablePriorityQueue {
     std::vector<T *> H;
+    Compare cmp;
     void heapifyUp(unsigned i);
     void heapifyDown(unsigned i);
     inline void set(unsigned i, T * x);
 public:
     MutablePriorityQueue();
+    explicit MutablePriorityQueue(Compare compare);
     void insert(T * x);
     T * extractMin();
+    T * top();
     void decreaseKey(T * x);
+    void increaseKey(T * x);
+    void updateKey(T * x);
+    void remove(T * x);
     bool empty();
+    unsigned size();
 };
 
 // Index calculations
 #define parent(i) ((i) / 2)
 #define leftChild(i) ((i) * 2)
 
-template <class T>
-MutablePriorityQueue<T>::MutablePriorityQueue() {
+template <class T, class Compare>
+MutablePriorityQueue<T, Compare>::MutablePriorityQueue() {
     H.push_back(nullptr);
     // indices will be used starting in 1
     // to facilitate parent/child calculations
 }
 
-template <class T>
-bool MutablePriorityQueue<T>::empty() {
+template <class T, class Compare>
+MutablePriorityQueue<T, Compare>::MutablePriorityQueue(Compare compare): cmp(compare) {
+    H.push_back(nullptr);
+}
+
+template <class T, class Compare>
+bool MutablePriorityQueue<T, Compare>::empty() {
     return H.size() == 1;
 }
 
-template <class T>
-T* MutablePriorityQueue<T>::extractMin() {
+template <class T, class Compare>
+unsigned MutablePriorityQueue<T, Compare>::size() {
+    return H.size() - 1;
+}
+
+template <class T, class Compare>
+T* MutablePriorityQueue<T, Compare>::extractMin() {
+    INSTRUMENT_COUNT(QUEUE_EXTRACT_MINS);
     auto x = H[1];
     H[1] = H.back();
     H.pop_back();
@@ -43,37 +80,68 @@ T* MutablePriorityQueue<T>::extractMin() {
     return x;
 }
 
-template <class T>
-void MutablePriorityQueue<T>::insert(T *x) {
+template <class T, class Compare>
+T* MutablePriorityQueue<T, Compare>::top() {
+    return H[1];
+}
+
+template <class T, class Compare>
+void MutablePriorityQueue<T, Compare>::insert(T *x) {
+    INSTRUMENT_COUNT(QUEUE_INSERTS);
     H.push_back(x);
     heapifyUp(H.size()-1);
 }
 
-template <class T>
-void MutablePriorityQueue<T>::decreaseKey(T *x) {
+template <class T, class Compare>
+void MutablePriorityQueue<T, Compare>::decreaseKey(T *x) {
+    INSTRUMENT_COUNT(QUEUE_DECREASE_KEYS);
     heapifyUp(x->queueIndex);
 }
 
-template <class T>
-void MutablePriorityQueue<T>::heapifyUp(unsigned i) {
+template <class T, class Compare>
+void MutablePriorityQueue<T, Compare>::increaseKey(T *x) {
+    heapifyDown(x->queueIndex);
+}
+
+template <class T, class Compare>
+void MutablePriorityQueue<T, Compare>::updateKey(T *x) {
+    // only one of them moves the element
+    heapifyUp(x->queueIndex);
+    heapifyDown(x->queueIndex);
+}
+
+template <class T, class Compare>
+void MutablePriorityQueue<T, Compare>::remove(T *x) {
+    unsigned i = x->queueIndex;
+    auto last = H.back();
+    H.pop_back();
+    x->queueIndex = 0;
+    if (last != x) {
+        set(i, last);
+        updateKey(last);
+    }
+}
+
+template <class T, class Compare>
+void MutablePriorityQueue<T, Compare>::heapifyUp(unsigned i) {
     auto x = H[i];
-    while (i > 1 && *x < *H[parent(i)]) {
+    while (i > 1 && cmp(x, H[parent(i)])) {
         set(i, H[parent(i)]);
         i = parent(i);
     }
     set(i, x);
 }
 
-template <class T>
-void MutablePriorityQueue<T>::heapifyDown(unsigned i) {
+template <class T, class Compare>
+void MutablePriorityQueue<T, Compare>::heapifyDown(unsigned i) {
     auto x = H[i];
     while (true) {
         unsigned k = leftChild(i);
         if (k >= H.size())
             break;
-        if (k+1 < H.size() && *H[k+1] < *H[k])
+        if (k+1 < H.size() && cmp(H[k+1], H[k]))
             ++k; // right child of i
-        if ( ! (*H[k] < *x) )
+        if ( ! cmp(H[k], x) )
             break;
         set(i, H[k]);
         i = k;
@@ -81,8 +149,8 @@ void MutablePriorityQueue<T>::heapifyDown(unsigned i) {
     set(i, x);
 }
 
-template <class T>
-void MutablePriorityQueue<T>::set(unsigned i, T * x) {
+template <class T, class Compare>
+void MutablePriorityQueue<T, Compare>::set(unsigned i, T * x) {
     H[i] = x;
     x->queueIndex = i;
 }
@@ -0,0 +1,95 @@
+#ifndef FEUP_DA2_PERFCOUNTERS_H
+#define FEUP_DA2_PERFCOUNTERS_H
+
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @brief Hardware performance counters of the calling thread and the threads it starts while counting (Linux
+ * perf_event_open, user space only)
+ * @details Each event is opened on its own, so an event the machine (or virtual machine) does not expose is left out
+ * instead of disabling the others, and the values are scaled when the kernel had to multiplex the counters.
+ * Threads that already existed when counting started (e.g. a ThreadPool built earlier) are not counted.
+ * On other systems, or when /proc/sys/kernel/perf_event_paranoid forbids it, no event is available.
+ */
+class PerfCounters {
+public:
+    /**
+     * @brief Events counted
+     */
+    enum Event {
+        CYCLES,
+        INSTRUCTIONS,
+        L1D_MISSES,
+        LLC_MISSES,
+        BRANCH_MISSES,
+        PAGE_FAULTS,
+        NUM_EVENTS
+    };
+
+private:
+    /**
+     * @brief File descriptor of each event while counting (-1 if it could not be opened)
+     */
+    int _fds[NUM_EVENTS];
+
+    /**
+     * @brief Value of each event in the last measurement (-1 if it was not available)
+     */
+    int64_t _values[NUM_EVENTS];
+
+public:
+    /**
+     * @brief Constructs the counters, nothing is measured until start
+     */
+    PerfCounters();
+
+    /**
+     * @brief Closes the events that are still open
+     */
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    /**
+     * @brief Open and enable the events
+     *
+     * @return true At least one event is counting
+     * @return false No event is available
+     */
+    bool start();
+
+    /**
+     * @brief Disable the events, read them and close them
+     */
+    void stop();
+
+    /**
+     * @brief Get the value of an event in the last measurement
+     *
+     * @param event Event to read
+     * @return int64_t Value (-1 if the event was not available)
+     */
+    int64_t get(Event event) const;
+
+    /**
+     * @brief Get the name of an event, as used in the reports
+     *
+     * @param event Event
+     * @return const char* Name (e.g. "llc_misses")
+     */
+    static const char* getName(Event event);
+
+    /**
+     * @brief Write the last measurement as a JSON object with the instructions per cycle and, for the misses, the
+     * count per vertex and per edge (null for the events that were not available)
+     *
+     * @param out Stream to write to
+     * @param num_vertex Number of vertexes of the graph solved
+     * @param num_edges Number of edges of the graph solved
+     */
+    void writeJson(std::ostream &out, std::size_t num_vertex, std::size_t num_edges) const;
+};
+
+#endif // FEUP_DA2_PERFCOUNTERS_H
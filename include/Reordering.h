@@ -0,0 +1,51 @@
+#ifndef FEUP_DA2_REORDERING_H
+#define FEUP_DA2_REORDERING_H
+
+#include "CompactGraph.h"
+
+#include <vector>
+
+/**
+ * @brief Vertex orders that place vertexes close in the graph at close indexes, so the traversals and the distance
+ * matrix rows touch fewer cache lines (see BasicCompactGraph::permute)
+ * @details An order lists the vertex at each new index, inverse gives the new index of each vertex
+ */
+namespace reordering {
+    /**
+     * @brief Reverse Cuthill-McKee order: a breadth first search from a low degree vertex of each component, visiting
+     * neighbors by increasing degree, reversed
+     * @details Time Complexity: O(|V| + |E|log(d)) where d is the maximum degree
+     *
+     * @param graph Graph to order
+     * @return std::vector<int> Vertex at each new index
+     */
+    std::vector<int> reverseCuthillMcKee(const CompactGraph &graph);
+
+    /**
+     * @brief Order of the vertexes along the Hilbert curve over their coordinates
+     * @details Time Complexity: O(|V|)
+     *
+     * @param graph Graph to order (must have coordinates)
+     * @return std::vector<int> Vertex at each new index
+     */
+    std::vector<int> hilbertOrder(const CompactGraph &graph);
+
+    /**
+     * @brief Hilbert order for graphs with coordinates, reverse Cuthill-McKee otherwise
+     *
+     * @param graph Graph to order
+     * @return std::vector<int> Vertex at each new index
+     */
+    std::vector<int> localityOrder(const CompactGraph &graph);
+
+    /**
+     * @brief Invert an order
+     * @details Time Complexity: O(n)
+     *
+     * @param order Vertex at each new index
+     * @return std::vector<int> New index of each vertex
+     */
+    std::vector<int> inverse(const std::vector<int> &order);
+}
+
+#endif // FEUP_DA2_REORDERING_H
@@ -0,0 +1,106 @@
+#ifndef FEUP_DA2_SIMULATEDANNEALING_H
+#define FEUP_DA2_SIMULATEDANNEALING_H
+
+#include "DistanceMatrix.h"
+#include "SolveControl.h"
+#include "TiledDistanceMatrix.h"
+
+#include <vector>
+
+/**
+ * @brief Simulated annealing over tours of vertex indexes, with parallel tempering when running several replicas
+ * @details Moves (2-opt, swap and insert between a vertex and one of its nearest neighbors) are evaluated in O(1)
+ * against the DistanceMatrix. The starting temperature is calibrated from the deltas of random moves and cooled
+ * geometrically over the elapsed time, so the schedule fits any time budget on any machine. Each replica runs on its
+ * own long-lived thread at a fixed multiple of the current temperature; the threads meet at a barrier after every round
+ * so neighboring replicas can swap tours. Each replica keeps the best tour it passed through, even in the middle of a
+ * round. Templated on the matrix type like the local search kernels, instantiated for DistanceMatrix and
+ * TiledDistanceMatrix.
+ */
+template<class Matrix>
+class BasicSimulatedAnnealing {
+private:
+    /**
+     * @brief Distances between vertexes
+     */
+    const Matrix &_dist;
+
+    /**
+     * @brief Nearest neighbors of each vertex, the candidates of every move
+     */
+    std::vector<std::vector<int>> _neighbors;
+
+    /**
+     * @brief Number of moves evaluated in the last run
+     */
+    unsigned long long _moves_evaluated = 0;
+
+    /**
+     * @brief Number of moves accepted in the last run
+     */
+    unsigned long long _moves_accepted = 0;
+
+    /**
+     * @brief Duration of the last run in seconds
+     */
+    double _elapsed = 0;
+
+public:
+    /**
+     * @brief Constructs the engine, calculating the neighbor lists
+     * @details Time Complexity: O(|V|^2 log(k))
+     *
+     * @param dist Distances between vertexes (must outlive the engine)
+     */
+    explicit BasicSimulatedAnnealing(const Matrix &dist);
+
+    /**
+     * @brief Constructs the engine with neighbor lists calculated beforehand (e.g. shared with the 2-opt moves)
+     * @details Time Complexity: O(|V| * k)
+     *
+     * @param dist Distances between vertexes (must outlive the engine)
+     * @param neighbors Nearest neighbors of each vertex, the same number for every vertex
+     */
+    BasicSimulatedAnnealing(const Matrix &dist, std::vector<std::vector<int>> neighbors);
+
+    /**
+     * @brief Anneal a tour until the time limit is reached
+     * @details With a control, the schedule is fitted to the time left before its deadline if that is shorter, and a
+     * cancel ends the run after the current round.
+     *
+     * @param tour Starting tour, replaced by the best tour found (output parameter)
+     * @param time_limit Time budget in seconds
+     * @param num_replicas Number of replicas, each on its own thread (1 for plain simulated annealing)
+     * @param control Deadline and cancellation (optional)
+     * @return double Cost of the best tour found
+     */
+    double run(std::vector<int> &tour, double time_limit, unsigned int num_replicas = 1, SolveControl* control = nullptr);
+
+    /**
+     * @brief Get the number of moves evaluated in the last run
+     *
+     * @return unsigned long long Moves evaluated
+     */
+    unsigned long long getMovesEvaluated() const;
+
+    /**
+     * @brief Get the number of moves accepted in the last run
+     *
+     * @return unsigned long long Moves accepted
+     */
+    unsigned long long getMovesAccepted() const;
+
+    /**
+     * @brief Get the throughput of the last run
+     *
+     * @return double Moves evaluated per second (over all replicas)
+     */
+    double getMovesPerSecond() const;
+};
+
+extern template class BasicSimulatedAnnealing<DistanceMatrix>;
+extern template class BasicSimulatedAnnealing<TiledDistanceMatrix>;
+
+using SimulatedAnnealing = BasicSimulatedAnnealing<DistanceMatrix>;
+
+#endif // FEUP_DA2_SIMULATEDANNEALING_H
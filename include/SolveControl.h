@@ -0,0 +1,192 @@
+#ifndef FEUP_DA2_SOLVECONTROL_H
+#define FEUP_DA2_SOLVECONTROL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Deadline, cancellation and progress of a solve, shared by the solver and whoever started it
+ * @details Solvers poll it in their search and improvement loops and, once it says stop, return the best tour they
+ * have so far. Tour construction (nearest neighbor, Hilbert curve, the clusters' tours) is never interrupted since
+ * there is no tour before it ends, only the improvement after it is cut short. Exact solvers also report through it
+ * whether their result is proven optimal. While running, solvers publish the cost of their best tour and a count of
+ * their own unit of work (nodes, moves, kicks...), so another thread can follow the solve.
+ */
+class SolveControl {
+private:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Calls of poll between two reads of the clock on the same thread
+     */
+    static constexpr unsigned int POLL_INTERVAL = 1024;
+
+    /**
+     * @brief When the solve must stop (clock::time_point::max() for no deadline)
+     */
+    clock::time_point _deadline;
+
+    /**
+     * @brief Set once the solve was cancelled or the deadline passed, never cleared
+     */
+    std::atomic<bool> _stop{false};
+
+    /**
+     * @brief If the solver proved its result optimal
+     */
+    std::atomic<bool> _optimal{false};
+
+    /**
+     * @brief Cost of the best tour reported so far (infinity before the first one)
+     */
+    std::atomic<double> _best_cost;
+
+    /**
+     * @brief Work done so far, in the unit of the solver
+     */
+    std::atomic<uint64_t> _work{0};
+
+    /**
+     * @brief Per thread state of poll: the control it belongs to, calls left until the next clock read and work not
+     * published yet
+     */
+    struct PollState {
+        const SolveControl* owner = nullptr;
+        unsigned int countdown = 0;
+        uint64_t pending = 0;
+    };
+
+    /**
+     * @brief Get the poll state of the calling thread
+     *
+     * @return PollState& State, shared by every control the thread polls
+     */
+    static PollState &pollState() {
+        thread_local PollState state;
+        return state;
+    }
+
+public:
+    /**
+     * @brief Constructs a control with no deadline, the solve only stops if cancelled
+     */
+    SolveControl();
+
+    /**
+     * @brief Constructs a control with a deadline
+     *
+     * @param time_limit Seconds from now until the deadline (0 or less for no deadline)
+     */
+    explicit SolveControl(double time_limit);
+
+    SolveControl(const SolveControl &) = delete;
+    SolveControl &operator=(const SolveControl &) = delete;
+
+    /**
+     * @brief Ask the solve to stop as soon as possible, safe to call from any thread
+     */
+    void cancel();
+
+    /**
+     * @brief Check if the solve must stop, reading the clock
+     *
+     * @return true Cancelled or past the deadline
+     * @return false Keep going
+     */
+    bool shouldStop();
+
+    /**
+     * @brief Check if the solve must stop, reading the clock only every POLL_INTERVAL calls of the calling thread,
+     * for the innermost loops
+     * @details The countdown and the batched work belong to the control the thread polled last, polling another
+     * control starts over (a thread that moves between controls must call flush first or its batch is dropped).
+     *
+     * @param work Work done since the last call, published in batches together with the clock reads
+     * @return true Cancelled or past the deadline (noticed up to POLL_INTERVAL calls late)
+     * @return false Keep going
+     */
+    bool poll(uint64_t work = 0) {
+        PollState &state = pollState();
+        if (state.owner != this) {
+            state.owner = this;
+            state.countdown = 0;
+            state.pending = 0;
+        }
+        state.pending += work;
+        if (state.countdown-- != 0) {
+            return _stop.load(std::memory_order_relaxed);
+        }
+        state.countdown = POLL_INTERVAL - 1;
+        addWork(state.pending);
+        state.pending = 0;
+        return shouldStop();
+    }
+
+    /**
+     * @brief Publish the work the calling thread batched in poll and forget this control on the thread, called by
+     * every thread that polled it once it is done with the solve
+     */
+    void flush();
+
+    /**
+     * @brief Check if the solve was told to stop, without reading the clock
+     *
+     * @return true A solver noticed the deadline or the solve was cancelled, the result may be cut short
+     * @return false The solve was not interrupted
+     */
+    bool isStopped() const;
+
+    /**
+     * @brief Get the time left until the deadline
+     *
+     * @param limit Value returned when there is no deadline
+     * @return double Seconds left (0 if stopped), at most limit
+     */
+    double getRemaining(double limit) const;
+
+    /**
+     * @brief Publish the cost of a tour, kept if it is the best one so far (called by the solvers)
+     *
+     * @param cost Cost of the tour
+     */
+    void reportCost(double cost);
+
+    /**
+     * @brief Publish work done (called by the solvers at coarse points, e.g. once per pass or per round)
+     *
+     * @param amount Work done since the last report
+     */
+    void addWork(uint64_t amount);
+
+    /**
+     * @brief Get the cost of the best tour reported so far
+     *
+     * @return double Cost (infinity if none was reported)
+     */
+    double getBestCost() const;
+
+    /**
+     * @brief Get the work done so far
+     *
+     * @return uint64_t Work, in the unit of the solver
+     */
+    uint64_t getWork() const;
+
+    /**
+     * @brief Record if the result of the solve is proven optimal (called by the solvers)
+     *
+     * @param optimal If the result is optimal
+     */
+    void setOptimal(bool optimal);
+
+    /**
+     * @brief Check if the solver proved its result optimal
+     *
+     * @return true Result is optimal
+     * @return false Result is a heuristic one, or the exact search was stopped early
+     */
+    bool isOptimal() const;
+};
+
+#endif // FEUP_DA2_SOLVECONTROL_H
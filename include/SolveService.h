@@ -0,0 +1,193 @@
+#ifndef FEUP_DA2_SOLVESERVICE_H
+#define FEUP_DA2_SOLVESERVICE_H
+
+#include "CompactGraph.h"
+#include "DistanceMatrix.h"
+#include "Graph.h"
+#include "ThreadPool.h"
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Solves many TSP variants (start vertexes, vertex subsets, algorithms) concurrently against one graph
+ * @details The graph is packed once, in locality order, into a CompactGraph that the requests only read, so unlike the
+ * Graph algorithms (which keep their state in the vertexes) any number of requests can run at the same time. Requests
+ * run on a bounded ThreadPool, one thread each, with the index kernels of LocalSearch and SimulatedAnnealing. Requests
+ * over every vertex share one DistanceMatrix, built by the first of them; requests over a subset build the matrix of
+ * their own vertexes only. A request whose matrix would not fit in the dense matrix limit of the graph is refused.
+ */
+class SolveService {
+public:
+    /**
+     * @brief One TSP variant to solve
+     */
+    struct Request {
+        /**
+         * @brief Solver: "nearest-neighbor", "ils", "annealing" or "bruteforce"
+         */
+        std::string algorithm = "nearest-neighbor";
+
+        /**
+         * @brief Id of the vertex the tour starts and ends at (added to the subset if missing)
+         */
+        int start = 0;
+
+        /**
+         * @brief Ids of the vertexes to visit (empty to visit every vertex)
+         */
+        std::vector<int> vertexes;
+
+        /**
+         * @brief If the nearest neighbor tour is improved with 2-opt (nearest-neighbor)
+         */
+        bool two_opt = true;
+
+        /**
+         * @brief Time budget in seconds (ils, annealing)
+         */
+        double time_limit = 1;
+
+        /**
+         * @brief Seconds after which any solver returns its best tour so far, counted from when a worker picks the
+         * request up (0 for none)
+         */
+        double deadline = 0;
+
+        /**
+         * @brief Seed of the random moves (ils, annealing)
+         */
+        uint64_t seed = 1;
+    };
+
+    /**
+     * @brief Outcome of a request
+     */
+    struct Result {
+        /**
+         * @brief Vertex ids in visiting order, starting and ending at the start vertex (empty on error)
+         */
+        std::vector<int> tour;
+
+        /**
+         * @brief Cost of the tour (infinity if some consecutive vertexes are not connected)
+         */
+        double cost = 0;
+
+        /**
+         * @brief Seconds spent solving, without the time waiting in the queue
+         */
+        double solve_time = 0;
+
+        /**
+         * @brief If the tour is proven optimal (bruteforce that was not stopped)
+         */
+        bool optimal = false;
+
+        /**
+         * @brief If the deadline cut the solve short
+         */
+        bool stopped = false;
+
+        /**
+         * @brief Why the request could not be solved (empty on success)
+         */
+        std::string error;
+    };
+
+private:
+    /**
+     * @brief Packed copy of the graph in locality order, never modified after construction
+     */
+    CompactGraph _graph;
+
+    /**
+     * @brief Index in _graph of each vertex id
+     */
+    std::vector<int> _index_of;
+
+    /**
+     * @brief Distances between every pair of vertexes, shared by the requests over every vertex
+     */
+    std::unique_ptr<DistanceMatrix> _full_matrix;
+
+    /**
+     * @brief Nearest neighbors of every vertex in _full_matrix
+     */
+    std::vector<std::vector<int>> _full_neighbors;
+
+    /**
+     * @brief Builds _full_matrix and _full_neighbors once
+     */
+    std::once_flag _full_once;
+
+    /**
+     * @brief Largest distance matrix a request may build, in bytes (the dense matrix limit of the graph)
+     */
+    std::size_t _matrix_limit;
+
+    /**
+     * @brief Workers running the requests (last member, so it is joined before the data it reads is destroyed)
+     */
+    ThreadPool _pool;
+
+    /**
+     * @brief Solve a request on the calling thread
+     *
+     * @param request Request to solve
+     * @return Result Tour and cost, or the error
+     */
+    Result solve(const Request &request);
+
+public:
+    /**
+     * @brief Constructs the service, packing the graph
+     * @details Time Complexity: O(|V| + |E|log(d)), the graph is not used after the constructor returns (its dense
+     * matrix limit is copied)
+     *
+     * @param graph Graph to solve on
+     * @param num_threads Number of requests solved at the same time (0 to use every available core)
+     */
+    explicit SolveService(const Graph &graph, unsigned int num_threads = 0);
+
+    /**
+     * @brief Check if the service can run an algorithm
+     *
+     * @param algorithm Algorithm name
+     * @return true One of the algorithms of Request::algorithm
+     * @return false Unknown to the service
+     */
+    static bool supports(const std::string &algorithm);
+
+    SolveService(const SolveService &) = delete;
+    SolveService &operator=(const SolveService &) = delete;
+
+    /**
+     * @brief Queue a request
+     *
+     * @param request Request to solve (copied)
+     * @return std::future<Result> Result, ready when a worker solved it
+     */
+    std::future<Result> submit(const Request &request);
+
+    /**
+     * @brief Queue a list of requests, solved in any order
+     *
+     * @param requests Requests to solve
+     * @return std::vector<std::future<Result>> Result of each request, in the same order
+     */
+    std::vector<std::future<Result>> submitAll(const std::vector<Request> &requests);
+
+    /**
+     * @brief Get the number of requests solved at the same time
+     *
+     * @return unsigned int Number of workers
+     */
+    unsigned int getNumWorkers() const;
+};
+
+#endif // FEUP_DA2_SOLVESERVICE_H
@@ -0,0 +1,88 @@
+#ifndef FEUP_DA2_THREADPOOL_H
+#define FEUP_DA2_THREADPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed number of worker threads running queued tasks in FIFO order
+ */
+class ThreadPool {
+private:
+    /**
+     * @brief Worker threads
+     */
+    std::vector<std::thread> _workers;
+
+    /**
+     * @brief Tasks waiting for a worker
+     */
+    std::queue<std::function<void()>> _tasks;
+
+    std::mutex _mutex;
+
+    std::condition_variable _condition;
+
+    /**
+     * @brief If the pool is being destroyed (workers finish the queued tasks and exit)
+     */
+    bool _stopping = false;
+
+    /**
+     * @brief Loop run by each worker
+     */
+    void work();
+
+public:
+    /**
+     * @brief Constructs the pool and starts the workers
+     *
+     * @param num_threads Number of workers (0 to use every available core)
+     */
+    explicit ThreadPool(unsigned int num_threads = 0);
+
+    /**
+     * @brief Waits for the queued tasks to finish and joins the workers
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * @brief Queue a task
+     *
+     * @param task Callable without arguments
+     * @return std::future Result of the task (rethrows its exception on get)
+     */
+    template <class F>
+    auto submit(F &&task) -> std::future<decltype(task())>;
+
+    /**
+     * @brief Get the number of workers
+     *
+     * @return unsigned int Number of workers
+     */
+    unsigned int size() const;
+};
+
+template <class F>
+auto ThreadPool::submit(F &&task) -> std::future<decltype(task())> {
+    using R = decltype(task());
+    auto packaged = std::make_shared<std::packaged_task<R()>>(std::forward<F>(task));
+    std::future<R> result = packaged->get_future();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tasks.emplace([packaged]() { (*packaged)(); });
+    }
+    _condition.notify_one();
+    return result;
+}
+
+#endif // FEUP_DA2_THREADPOOL_H
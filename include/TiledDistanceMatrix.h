@@ -0,0 +1,154 @@
+#ifndef FEUP_DA2_TILEDDISTANCEMATRIX_H
+#define FEUP_DA2_TILEDDISTANCEMATRIX_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+template<class W> class BasicCompactGraph;
+
+/**
+ * @brief Symmetric distance matrix stored on disk and memory mapped, for instances whose |V|^2 distances do not fit in
+ * memory. Same interface as DistanceMatrix, so the local search kernels run on it unchanged.
+ * @details The upper triangle is split in square tiles of floats, each tile a whole number of pages and stored
+ * contiguously, so distances between vertexes close in the tour (and in id) come from a few pages. A direct-mapped
+ * cache remembers which tiles are resident: admitting a tile asks the kernel to read it ahead (MADV_WILLNEED) and
+ * evicting one releases its pages (MADV_DONTNEED), which bounds the memory used to about cache_tiles tiles.
+ * Lookups can run from several threads at once. Vertexes are indexed like the graph the matrix was created from.
+ * On systems without mmap the file is read into memory instead, so only the interface is kept.
+ */
+class TiledDistanceMatrix {
+private:
+    /**
+     * @brief Number of vertexes (rows and columns)
+     */
+    std::size_t _size = 0;
+
+    /**
+     * @brief Tile side is 2^_tile_shift
+     */
+    unsigned int _tile_shift = 0;
+
+    /**
+     * @brief Number of tiles along each side of the matrix
+     */
+    std::size_t _tiles_per_side = 0;
+
+    /**
+     * @brief Mapped file (or the buffer it was read into) and its length
+     */
+    void* _map = nullptr;
+    std::size_t _map_length = 0;
+
+    /**
+     * @brief First tile in the mapping
+     */
+    const float* _tiles = nullptr;
+
+    /**
+     * @brief Tile held by each cache slot (-1 if empty)
+     */
+    std::unique_ptr<std::atomic<int64_t>[]> _cache;
+    std::size_t _cache_slots = 0;
+
+    /**
+     * @brief Index of the tile holding a pair of tile coordinates (row <= col)
+     *
+     * @param row Tile row
+     * @param col Tile column
+     * @return std::size_t Tile index in the file
+     */
+    std::size_t tileIndex(std::size_t row, std::size_t col) const {
+        return row * _tiles_per_side - row * (row - 1) / 2 + (col - row);
+    }
+
+    /**
+     * @brief Put a tile in its cache slot, releasing the pages of the tile it replaces
+     *
+     * @param tile Tile index
+     * @param slot Cache slot
+     */
+    void admit(std::size_t tile, std::size_t slot) const;
+
+public:
+    TiledDistanceMatrix() = default;
+
+    TiledDistanceMatrix(const TiledDistanceMatrix &) = delete;
+
+    TiledDistanceMatrix& operator=(const TiledDistanceMatrix &) = delete;
+
+    /**
+     * @brief Unmaps the file
+     */
+    ~TiledDistanceMatrix();
+
+    /**
+     * @brief Write the distance matrix of a graph to a file, one row of tiles at a time: the weight of the edge between
+     * two vertexes, otherwise their haversine distance if the graph has coordinates, otherwise infinity
+     * @details Time Complexity: O(|V|^2 + |E|), uses O(|V| * tile_size) memory
+     *
+     * @param path File path
+     * @param graph Graph to read the distances from (e.g. Graph::getLocalityGraph, so close vertexes share tiles)
+     * @param tile_size Tile side, rounded up to a power of two of at least 32 (so a tile fills whole pages)
+     * @return true Matrix was written
+     * @return false File could not be written
+     */
+    static bool create(const std::string &path, const BasicCompactGraph<double> &graph, unsigned int tile_size = 64);
+
+    /**
+     * @brief Map a file written by create
+     *
+     * @param path File path
+     * @param cache_tiles Number of tiles kept resident (each tile_size^2 * 4 bytes)
+     * @return true Matrix was opened
+     * @return false File could not be read or is not a tiled matrix
+     */
+    bool open(const std::string &path, std::size_t cache_tiles = 4096);
+
+    /**
+     * @brief Unmap the file (the matrix becomes empty)
+     */
+    void close();
+
+    /**
+     * @brief Get the distance between two vertexes
+     *
+     * @param i Source vertex index
+     * @param j Destination vertex index
+     * @return double Distance
+     */
+    double operator()(std::size_t i, std::size_t j) const {
+        if (i > j) {
+            std::swap(i, j);
+        }
+        std::size_t mask = ((std::size_t) 1 << _tile_shift) - 1;
+        std::size_t tile = tileIndex(i >> _tile_shift, j >> _tile_shift);
+        std::size_t slot = tile % _cache_slots;
+        if (_cache[slot].load(std::memory_order_relaxed) != (int64_t) tile) {
+            admit(tile, slot);
+        }
+        return _tiles[(tile << (2 * _tile_shift)) + ((i & mask) << _tile_shift) + (j & mask)];
+    }
+
+    /**
+     * @brief Get the number of vertexes
+     *
+     * @return std::size_t Number of vertexes
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Calculate the cost of a closed tour
+     * @details Time Complexity: O(n)
+     *
+     * @param tour Vertex indexes in visiting order (without repeating the first one at the end)
+     * @return double Cost of the tour, including the edge back to the start
+     */
+    double tourCost(const std::vector<int> &tour) const;
+};
+
+#endif // FEUP_DA2_TILEDDISTANCEMATRIX_H
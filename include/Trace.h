@@ -0,0 +1,78 @@
+#ifndef FEUP_DA2_TRACE_H
+#define FEUP_DA2_TRACE_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Timeline of the solver phases, written as a Chrome trace-event JSON file (chrome://tracing, Perfetto)
+ * @details Spans are recorded from every thread while a trace is running and cost one relaxed atomic load otherwise,
+ * so they are only placed around coarse work (phases, passes, tasks), never inside the hot loops. In instrumented
+ * builds every span also adds to the phase totals of the instrumentation report (see Instrumentation.h), and with
+ * allocation tracking it is the phase the allocations of its thread are attributed to (see Allocations.h).
+ */
+namespace trace {
+    /**
+     * @brief Start recording, dropping the spans of a previous trace
+     */
+    void start();
+
+    /**
+     * @brief Stop recording (the recorded spans are kept until the next start)
+     */
+    void stop();
+
+    /**
+     * @brief Check if a trace is being recorded
+     *
+     * @return true Spans are recorded
+     * @return false Spans are ignored
+     */
+    bool isRecording();
+
+    /**
+     * @brief Write the recorded spans as complete ("X") events, one timeline row per thread
+     * @details Time Complexity: O(S) where S is the number of spans
+     *
+     * @param path File path
+     * @return true File was written
+     * @return false File could not be written
+     */
+    bool write(const std::string &path);
+
+    /**
+     * @brief Records its lifetime as a span of the calling thread
+     */
+    class Span {
+    private:
+        const char* _name;
+        int64_t _index;
+        bool _recording;
+        int _parent_phase;
+        std::chrono::steady_clock::time_point _start;
+
+    public:
+        /**
+         * @brief Starts a span (nothing is recorded if no trace is running)
+         *
+         * @param name Name of the span (must be a string literal or outlive the trace)
+         * @param index Optional number shown with the span, e.g. the pass or the cluster (negative for none)
+         */
+        explicit Span(const char* name, int64_t index = -1);
+
+        /**
+         * @brief Ends the span
+         */
+        ~Span();
+
+        Span(const Span &) = delete;
+        Span &operator=(const Span &) = delete;
+    };
+}
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SPAN(...) trace::Span TRACE_CONCAT(trace_span_, __LINE__)(__VA_ARGS__)
+
+#endif // FEUP_DA2_TRACE_H
@@ -0,0 +1,147 @@
+#ifndef FEUP_DA2_UNDIRECTEDGRAPH_H
+#define FEUP_DA2_UNDIRECTEDGRAPH_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Undirected graph for symmetric TSP, every edge is stored once in a flat edge array and both of its endpoints
+ * index into it (incidence lists in CSR layout)
+ * @details Loaded straight from the csv files without going through Graph, so no Vertex or Edge objects are created:
+ * an edge takes 24 bytes (2 endpoint ids, a weight and an entry in the incidence list of each endpoint) instead of two
+ * Edge objects, their entries in the adjacency and incomming lists and the allocator overhead of each.
+ * Vertex ids must go from 0 to |V| - 1.
+ */
+class UndirectedGraph {
+private:
+    /**
+     * @brief Endpoints of each edge (edge e connects _ends[2e] and _ends[2e + 1])
+     */
+    std::vector<int> _ends;
+
+    /**
+     * @brief Weight of each edge
+     */
+    std::vector<double> _weights;
+
+    /**
+     * @brief Index of the first incident edge of each vertex (|V| + 1 entries)
+     */
+    std::vector<int> _offsets;
+
+    /**
+     * @brief Edges incident to each vertex
+     */
+    std::vector<int> _incidence;
+
+    /**
+     * @brief Coordinates of each vertex (empty if no nodes file was loaded)
+     */
+    std::vector<double> _longitudes;
+    std::vector<double> _latitudes;
+
+    /**
+     * @brief Build the incidence lists from the edge array (counting sort by endpoint)
+     * @details Time Complexity: O(|V|+|E|)
+     *
+     * @param num_vertex Number of vertexes
+     */
+    void buildIncidence(int num_vertex);
+
+public:
+    /**
+     * @brief Read a graph from the csv files (same format as the Menu: a header line, then origin,destination,distance
+     * and id,longitude,latitude)
+     * @details Time Complexity: O(|V|+|E|)
+     *
+     * @param edges_file Path of the edges file
+     * @param nodes_file Path of the nodes file (empty for graphs without coordinates)
+     * @return true Graph was loaded
+     * @return false A file could not be read or has a field that is not a number
+     */
+    bool load(const std::string &edges_file, const std::string &nodes_file = "");
+
+    /**
+     * @brief Get the number of vertexes
+     *
+     * @return int Number of vertexes
+     */
+    int getNumVertex() const;
+
+    /**
+     * @brief Get the number of (undirected) edges
+     *
+     * @return std::size_t Number of edges
+     */
+    std::size_t getNumEdges() const;
+
+    int incidentBegin(int v) const { return _offsets[v]; }
+
+    int incidentEnd(int v) const { return _offsets[v + 1]; }
+
+    int getIncident(int i) const { return _incidence[i]; }
+
+    int getOther(int e, int v) const { return _ends[2 * e] == v ? _ends[2 * e + 1] : _ends[2 * e]; }
+
+    double getWeight(int e) const { return _weights[e]; }
+
+    /**
+     * @brief If the vertexes have coordinates
+     *
+     * @return true A nodes file was loaded
+     * @return false Graph has no coordinates
+     */
+    bool hasCoordinates() const;
+
+    /**
+     * @brief Calculate the distance between two vertexes using the Haversine formula (needs coordinates)
+     *
+     * @param u First vertex
+     * @param v Second vertex
+     * @return double The distance between the two vertexes
+     */
+    double haversine(int u, int v) const;
+
+    /**
+     * @brief Find the distance between two vertexes: the weight of the edge between them, or the haversine distance
+     * if there is no edge and the graph has coordinates (infinity otherwise)
+     * @details Time Complexity: O(min(deg(u), deg(v)))
+     *
+     * @param u First vertex
+     * @param v Second vertex
+     * @return double Distance
+     */
+    double findDistance(int u, int v) const;
+
+    /**
+     * @brief Minimum Spanning Tree (MST) using Prim's algorithm
+     * @details Time Complexity: O(|E|log(|V|))
+     *
+     * @param root Root of the tree
+     * @param parent Parent of each vertex in the tree, -1 for the root and unreachable vertexes (output parameter)
+     * @param order Vertexes in the order they joined the tree (output parameter)
+     * @return double Total weight of the tree
+     */
+    double prim(int root, std::vector<int> &parent, std::vector<int> &order) const;
+
+    /**
+     * @brief Approximate the TSP tour with a preorder walk of the MST, children visited in the order they joined the
+     * tree like Graph::triangularApproximation (the MST it walks is never sorted, see Graph::sortAdjacency). Vertexes
+     * unreachable from vertex 0 are left out.
+     * @details Time Complexity: O(|E|log(|V|) + |V| * d) where d is the average degree
+     *
+     * @param tour Vertex indexes in visiting order, starting at vertex 0 (output parameter)
+     * @return double Cost of the tour, including the edge back to vertex 0
+     */
+    double triangularApproximation(std::vector<int> &tour) const;
+
+    /**
+     * @brief Get the memory used by the graph arrays
+     *
+     * @return std::size_t Size in bytes
+     */
+    std::size_t memoryUsage() const;
+};
+
+#endif // FEUP_DA2_UNDIRECTEDGRAPH_H
@@ -1,6 +1,8 @@
 #ifndef FEUP_DA2_UTILS_H
 #define FEUP_DA2_UTILS_H
 
+#include <string>
+
 namespace utils {
     /**
      * @brief Clears the screen
@@ -11,6 +13,15 @@ namespace utils {
      * @brief Waits for the user to press enter
      */
     void waitEnter();
+
+    /**
+     * @brief Check if a line of a file has only whitespace (e.g. a trailing blank line of a csv file)
+     *
+     * @param line Line to check
+     * @return true Line is empty or whitespace
+     * @return false Line has some other character
+     */
+    bool isBlank(const std::string &line);
 }
 
 #endif // FEUP_DA2_UTILS_H
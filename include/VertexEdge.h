@@ -1,10 +1,54 @@
 #ifndef FEUP_DA2_VERTEXEDGE_H
 #define FEUP_DA2_VERTEXEDGE_H
 
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 class Edge;
 
+/**
+ * @brief Rarely used edge fields (flow and an explicitly set reverse edge), kept in the cold part of the origin vertex
+ * so an Edge is only its destination, weight and origin
+ */
+struct EdgeCold {
+    /**
+     * @brief Reverse edge set with Edge::setReverse (nullptr to look the twin up)
+     */
+    Edge* reverse = nullptr;
+
+    /**
+     * @brief Edge flow
+     */
+    double flow = 0;
+};
+
+/**
+ * @brief Rarely used vertex fields (DAG and topsort state, incomming edges, cold fields of the outgoing edges), kept
+ * out of the Vertex so the fields read by every traversal share fewer cache lines. Allocated on first use.
+ */
+struct VertexCold {
+    /**
+     * @brief If vertex is processing (used for DAGs)
+     */
+    bool processing = false;
+
+    /**
+     * @brief Vertex indegree (used for topsort)
+     */
+    unsigned int indegree = 0;
+
+    /**
+     * @brief Incomming edges to the vertex (only filled by Graph when a search needs them, see addIncomming)
+     */
+    std::vector<Edge *> incomming;
+
+    /**
+     * @brief Cold fields of the outgoing edges that ever had a flow or a reverse set
+     */
+    std::unordered_map<const Edge *, EdgeCold> edges;
+};
+
 /**
  * @brief Vertex of a graph.
  */
@@ -15,47 +59,58 @@ private:
      */
     int _id;
 
+public:
     /**
-     * @brief Adjacency list of edges
+     * @brief Index of the vertex in the mutable priority queue (next to the id, in what would be padding)
      */
-    std::vector<Edge *> _adj;
+    int queueIndex = 0;
 
+private:
     /**
      * @brief If vertex was visited
      */
     bool _visited = false;
 
     /**
-     * @brief If vertex is processing (used for DAGs)
+     * @brief If _adj is sorted by destination id (false after an edge is added out of order, see sortAdjacency)
      */
-    bool _processing = false;
+    bool _adj_sorted = true;
 
     /**
-     * @brief Vertex indegree (used for topsort)
+     * @brief Adjacency list of edges, in insertion order until sortAdjacency sorts it by destination id
      */
-    unsigned int _indegree;
+    std::vector<Edge *> _adj;
 
     /**
-     * @brief Path traveled until this vertex
+     * @brief Destination id of each edge in _adj, searched by getEdge without touching the edges
      */
-    Edge* _path = nullptr;
+    std::vector<int> _adj_ids;
 
     /**
-     * @brief Incomming edges to the vertex
+     * @brief Cost from source to the vertex
      */
-    std::vector<Edge *> _incomming;
+    double _distance = 0;
 
     /**
-     * @brief Cost from source to the vertex
+     * @brief Path traveled until this vertex
      */
-     double _distance = 0;
+    Edge* _path = nullptr;
 
-public:
     /**
-     * @brief Index of the vertex in the mutable priority queue
+     * @brief Rarely used fields (nullptr until one is set)
      */
-    int queueIndex = 0;
+    std::unique_ptr<VertexCold> _cold;
 
+    /**
+     * @brief Get the cold fields, allocating them if needed
+     *
+     * @return VertexCold& Cold fields
+     */
+    VertexCold& cold();
+
+    friend class Edge;
+
+public:
     /**
      * @brief Compare two vertexes by their distance
      * 
@@ -67,8 +122,6 @@ public:
 
     Vertex(int id);
 
-    virtual ~Vertex() = default;
-
     /**
      * @brief Get the vertex id
      *
@@ -85,6 +138,8 @@ public:
 
     /**
      * @brief Gets the edge connecting this vertex to the specified destination vertex.
+     * @details Time Complexity: O(log(d)) where d is the vertex degree (binary search), O(d) if the adjacency list is
+     * not sorted
      * 
      * @param dest_id The destination vertex id.
      * @return The edge connecting this vertex to the destination vertex, or nullptr if not found.
@@ -130,6 +185,7 @@ public:
 
     /**
      * @brief Get incomming edges to the vertex
+     * @details Not kept up to date by addEdge, empty unless they were added with addIncomming
      *
      * @return std::vector<Edge*> incommingEdges
      */
@@ -178,7 +234,8 @@ public:
     void setPath(Edge* path);
 
     /**
-     * @brief Add an edge with vertex as origin
+     * @brief Add an edge with vertex as origin, at the end of the adjacency list
+     * @details Time Complexity: O(1) amortized
      *
      * @param dest Destination Vertex
      * @param weight Edge weight
@@ -186,6 +243,25 @@ public:
      */
     Edge* addEdge(Vertex* dest, double weight);
 
+    /**
+     * @brief Sort the adjacency list by destination id (edges to the same destination keep their order), so getEdge
+     * can binary search it
+     * @details Time Complexity: O(d log(d)), O(1) if it is already sorted
+     */
+    void sortAdjacency();
+
+    /**
+     * @brief Add an incomming edge to the vertex
+     *
+     * @param edge Edge with the vertex as destination
+     */
+    void addIncomming(Edge* edge);
+
+    /**
+     * @brief Remove every incomming edge of the vertex
+     */
+    void clearIncomming();
+
     /**
      * @brief Remove an edge with the vertex as origin
      *
@@ -196,6 +272,11 @@ public:
     bool removeEdge(int destId);
 };
 
+/**
+ * @brief Vertex with coordinates, the only kind of vertex in a graph in coordinate mode
+ * @details Vertex has no virtual functions (not even the destructor, to keep the vtable pointer out of every vertex),
+ * so Graph casts to LongLatVertex only when it is in coordinate mode, and deletes through the right type.
+ */
 class LongLatVertex: public Vertex {
 private:
     /**
@@ -232,6 +313,17 @@ public:
      * @return double The distance between the two vertexes
      */
     double haversine(LongLatVertex* other);
+
+    /**
+     * @brief Calculate the distance between two points using the Haversine formula
+     *
+     * @param long1 Longitude of the first point
+     * @param lat1 Latitude of the first point
+     * @param long2 Longitude of the second point
+     * @param lat2 Latitude of the second point
+     * @return double The distance between the two points
+     */
+    static double haversine(double long1, double lat1, double long2, double lat2);
 };
 
 /**
@@ -255,14 +347,13 @@ private:
     Vertex* _origin;
 
     /**
-     * @brief Reverse edge (default is nullptr)
+     * @brief Cold fields of the edge, if it has any
+     *
+     * @return EdgeCold* Cold fields (nullptr if no flow or reverse was ever set)
      */
-    Edge* _reverse = nullptr;
+    EdgeCold* findCold() const;
 
-    /**
-     * @brief Edge flow
-     */
-    double _flow;
+    friend class Vertex;
 
 public:
     Edge(Vertex* origin, Vertex* dest, double weight);
@@ -289,9 +380,12 @@ public:
     Vertex* getOrigin() const;
 
     /**
-     * @brief Get reverse edge
+     * @brief Get reverse edge (the one set with setReverse, otherwise the edge from the destination back to the origin,
+     * which is how the twins made by Graph::addBidirectionalEdge find each other)
+     * @details Time Complexity: O(log(d)) where d is the degree of the destination (sorted adjacency, see
+     * Vertex::getEdge), O(1) on average when set
      *
-     * @return Edge* reverse
+     * @return Edge* reverse (nullptr if there is none)
      */
     Edge* getReverse() const;
 
@@ -303,14 +397,14 @@ public:
     double getFlow() const;
 
     /**
-     * @brief Set reverse edge
+     * @brief Set reverse edge, stored in the cold part of the origin
      *
-     * @param reverse reverse
+     * @param reverse reverse (nullptr to go back to looking the twin up)
      */
     void setReverse(Edge* reverse);
 
     /**
-     * @brief Set the flow
+     * @brief Set the flow, stored in the cold part of the origin
      *
      * @param flow Edge flow
      */
@@ -0,0 +1,56 @@
+#ifndef FEUP_DA2_WEIGHT_H
+#define FEUP_DA2_WEIGHT_H
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+/**
+ * @brief Helpers for the weight types the packed structures are instantiated with (float, int32_t and double)
+ */
+namespace weight {
+    /**
+     * @brief Value used for missing edges (infinity for floating point types, the maximum for integer ones)
+     *
+     * @tparam W Weight type
+     * @return W Unreachable weight
+     */
+    template<class W>
+    constexpr W infinity() {
+        return std::numeric_limits<W>::has_infinity ? std::numeric_limits<W>::infinity() : std::numeric_limits<W>::max();
+    }
+
+    /**
+     * @brief Convert a graph weight (double) to W, integer types are scaled and rounded
+     *
+     * @tparam W Weight type
+     * @param value Weight to convert (infinity maps to infinity<W>())
+     * @param scale Factor applied before converting (e.g. 100 keeps two decimal places in an integer)
+     * @return W Converted weight
+     */
+    template<class W>
+    W convert(double value, double scale = 1) {
+        double scaled = value * scale;
+        if (std::is_integral<W>::value) {
+            if (!(scaled < (double) infinity<W>())) {
+                return infinity<W>();
+            }
+            return (W) std::llround(scaled);
+        }
+        return (W) scaled;
+    }
+
+    /**
+     * @brief Convert a weight back to a double, infinity<W>() maps to infinity
+     *
+     * @tparam W Weight type
+     * @param value Weight to convert
+     * @return double Converted weight (still scaled)
+     */
+    template<class W>
+    double toDouble(W value) {
+        return value == infinity<W>() ? std::numeric_limits<double>::infinity() : (double) value;
+    }
+}
+
+#endif // FEUP_DA2_WEIGHT_H
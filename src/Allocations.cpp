@@ -0,0 +1,169 @@
+#include "Allocations.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// Every member is constant-initialized and nothing here allocates, so the hooks work before main, after it and while
+// threads finish
+struct Phase {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> frees{0};
+    std::atomic<uint64_t> peak{0};
+};
+
+// Phase 0 collects what happens outside of every span, later phases are claimed by name on first use
+static constexpr int MAX_PHASES = 128;
+static Phase phases[MAX_PHASES];
+static std::atomic<uint64_t> live_bytes{0};
+static std::atomic<uint64_t> peak_bytes{0};
+static thread_local int current_phase = 0;
+
+int allocation::enterPhase(const char* name) {
+    int previous = current_phase;
+    if (!ENABLED) {
+        return previous;
+    }
+
+    int found = 0; // phases past the table are counted as "(none)"
+    for (int p = 1; p < MAX_PHASES; p++) {
+        const char* slot = phases[p].name.load(std::memory_order_acquire);
+        if (slot == nullptr) {
+            if (phases[p].name.compare_exchange_strong(slot, name, std::memory_order_acq_rel)) {
+                found = p;
+                break;
+            }
+        }
+        if (slot == name || std::strcmp(slot, name) == 0) {
+            found = p;
+            break;
+        }
+    }
+
+    current_phase = found;
+    return previous;
+}
+
+void allocation::leavePhase(int previous) {
+    current_phase = previous;
+}
+
+void allocation::reset() {
+    uint64_t live = live_bytes.load(std::memory_order_relaxed);
+    for (Phase &phase: phases) {
+        phase.allocations = 0;
+        phase.bytes = 0;
+        phase.frees = 0;
+        phase.peak = live;
+    }
+    peak_bytes = live;
+}
+
+uint64_t allocation::liveBytes() {
+    return live_bytes.load(std::memory_order_relaxed);
+}
+
+void allocation::report(std::ostream &out) {
+    if (!ENABLED) {
+        out << "{}";
+        return;
+    }
+
+    out << "{\"peak_bytes\":" << peak_bytes.load() << ",\"phases\":{";
+    bool first = true;
+    for (int p = 0; p < MAX_PHASES; p++) {
+        const Phase &phase = phases[p];
+        if (phase.allocations == 0 && phase.frees == 0) {
+            continue;
+        }
+        out << (first ? "" : ",") << '"' << (p == 0 ? "(none)" : phase.name.load()) << "\":{\"allocations\":"
+            << phase.allocations.load() << ",\"bytes\":" << phase.bytes.load() << ",\"frees\":" << phase.frees.load()
+            << ",\"peak_bytes\":" << phase.peak.load() << '}';
+        first = false;
+    }
+    out << "}}";
+}
+
+#ifdef FEUP_DA2_TRACK_ALLOCATIONS
+// Each block starts with its size, so frees know how many bytes stop being live
+static constexpr std::size_t HEADER = alignof(std::max_align_t);
+
+static void raisePeak(std::atomic<uint64_t> &peak, uint64_t value) {
+    uint64_t old = peak.load(std::memory_order_relaxed);
+    while (value > old && !peak.compare_exchange_weak(old, value, std::memory_order_relaxed)) {}
+}
+
+static void* allocate(std::size_t size) {
+    auto* block = static_cast<unsigned char *>(std::malloc(size + HEADER));
+    if (block == nullptr) {
+        return nullptr;
+    }
+    *reinterpret_cast<std::size_t *>(block) = size;
+
+    Phase &phase = phases[current_phase];
+    uint64_t live = live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    phase.allocations.fetch_add(1, std::memory_order_relaxed);
+    phase.bytes.fetch_add(size, std::memory_order_relaxed);
+    raisePeak(phase.peak, live);
+    raisePeak(peak_bytes, live);
+    return block + HEADER;
+}
+
+static void deallocate(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    unsigned char* block = static_cast<unsigned char *>(ptr) - HEADER;
+    live_bytes.fetch_sub(*reinterpret_cast<std::size_t *>(block), std::memory_order_relaxed);
+    phases[current_phase].frees.fetch_add(1, std::memory_order_relaxed);
+    std::free(block);
+}
+
+void* operator new(std::size_t size) {
+    void* ptr = allocate(size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    return allocate(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    deallocate(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t &) noexcept {
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t &) noexcept {
+    deallocate(ptr);
+}
+#endif
@@ -0,0 +1,461 @@
+#include "Batch.h"
+#include "Allocations.h"
+#include "Generator.h"
+#include "GraphLoader.h"
+#include "Instrumentation.h"
+#include "PerfCounters.h"
+#include "SolveService.h"
+#include "Trace.h"
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+static const char* ALGORITHMS[] = {
+    "bruteforce", "triangular", "nearest-neighbor", "hilbert", "cheapest-insertion", "farthest-insertion",
+    "ils", "annealing", "clusters"
+};
+
+// Write a string as a JSON string literal
+static void writeString(std::ostream &out, const std::string &value) {
+    out << '"';
+    for (char c: value) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if ((unsigned char) c < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+// Number of undirected edges of a graph
+static std::size_t countEdges(const Graph &graph) {
+    std::size_t degrees = 0;
+    for (const auto &[id, vertex]: graph.getVertexSet()) {
+        degrees += vertex->getAdj().size();
+    }
+    return degrees / 2;
+}
+
+// Write a number, JSON has no infinity
+static void writeNumber(std::ostream &out, double value) {
+    if (std::isfinite(value)) {
+        out << value;
+    } else {
+        out << "null";
+    }
+}
+
+void Batch::printUsage(std::ostream &out) {
+    out << "Usage: feup_da2 [flags]          (no flags starts the interactive menu)\n"
+        << "  --edges FILE        edges csv file, or a binary instance written by feup_da2_gen\n"
+        << "  --nodes FILE        nodes csv file (Real World Graphs)\n"
+        << "  --algorithm NAME    solver to run\n"
+        << "  --two-opt N         2-opt iterations (nearest-neighbor), any N > 0 runs 2-opt until no move improves\n"
+        << "                      the tour (hilbert)\n"
+        << "  --threads N         threads, 0 for every core (ils, annealing, clusters)\n"
+        << "  --time-limit S      time budget in seconds (ils, annealing)\n"
+        << "  --deadline S        stop any solver after S seconds with its best tour so far, 0 for none\n"
+        << "  --cluster-size N    vertexes per cluster (clusters)\n"
+        << "  --matrix-limit MB   largest distance matrix kept in memory, larger ones are tiled on disk (ils,\n"
+        << "                      annealing; default 1024), with --workers larger ones are refused\n"
+        << "  --jobs FILE         run one job per line of FILE, each line holds flags overriding the ones above\n"
+        << "  --output FILE       write the results to FILE instead of the standard output\n"
+        << "  --no-tour           leave the tours out of the results\n"
+        << "  --trace FILE        write a Chrome trace-event timeline of the run to FILE\n"
+        << "  --perf              measure each solve with the hardware counters (Linux perf_event_open)\n"
+        << "  --workers N         solve N jobs at the same time on a shared read-only graph, 0 for every core\n"
+        << "                      (nearest-neighbor, ils, annealing, bruteforce)\n"
+        << "  --start ID          vertex the tour starts at (with --workers)\n"
+        << "  --subset A,B,...    only visit these vertexes (with --workers)\n"
+        << "Algorithms:";
+    for (const char* name: ALGORITHMS) {
+        out << ' ' << name;
+    }
+    out << '\n';
+}
+
+bool Batch::parseFlags(const std::vector<std::string> &args, Job &job, std::string &jobs_file) {
+    for (std::size_t i = 0; i < args.size(); i++) {
+        const std::string &flag = args[i];
+        if (flag == "--no-tour") {
+            _write_tour = false;
+            continue;
+        }
+        if (flag == "--perf") {
+            _perf = true;
+            continue;
+        }
+        if (flag == "--help") {
+            printUsage(std::cout);
+            return false;
+        }
+        if (i + 1 == args.size()) {
+            std::cerr << "Missing value for " << flag << '\n';
+            return false;
+        }
+
+        const std::string &value = args[++i];
+        try {
+            if (flag == "--edges") {
+                job.edges = value;
+            } else if (flag == "--nodes") {
+                job.nodes = value;
+            } else if (flag == "--algorithm") {
+                job.algorithm = value;
+            } else if (flag == "--two-opt") {
+                job.two_opt = std::stoul(value);
+            } else if (flag == "--threads") {
+                job.threads = std::stoul(value);
+            } else if (flag == "--time-limit") {
+                job.time_limit = std::stod(value);
+            } else if (flag == "--deadline") {
+                job.deadline = std::stod(value);
+            } else if (flag == "--cluster-size") {
+                job.cluster_size = std::stoul(value);
+            } else if (flag == "--matrix-limit") {
+                job.matrix_limit = (std::size_t) std::stoul(value) << 20;
+            } else if (flag == "--jobs") {
+                jobs_file = value;
+            } else if (flag == "--output") {
+                _output = value;
+            } else if (flag == "--trace") {
+                _trace = value;
+            } else if (flag == "--workers") {
+                _workers = std::stoul(value);
+                _service = true;
+            } else if (flag == "--start") {
+                job.start = std::stoi(value);
+            } else if (flag == "--subset") {
+                std::stringstream ss(value);
+                std::string id;
+                job.subset.clear();
+                while (getline(ss, id, ',')) {
+                    job.subset.push_back(std::stoi(id));
+                }
+            } else {
+                std::cerr << "Unknown flag " << flag << '\n';
+                return false;
+            }
+        } catch (const std::exception &) {
+            std::cerr << "Invalid value for " << flag << ": " << value << '\n';
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Batch::parse(int argc, char *argv[]) {
+    Job defaults;
+    std::string jobs_file;
+    if (!parseFlags(std::vector<std::string>(argv + 1, argv + argc), defaults, jobs_file)) {
+        return false;
+    }
+
+    if (jobs_file.empty()) {
+        _jobs.push_back(defaults);
+    } else {
+        std::ifstream input(jobs_file);
+        if (!input.is_open()) {
+            std::cerr << "Error opening " << jobs_file << '\n';
+            return false;
+        }
+
+        std::string line;
+        while (getline(input, line)) {
+            std::stringstream ss(line);
+            std::vector<std::string> args;
+            std::string arg;
+            while (ss >> arg) {
+                args.push_back(arg);
+            }
+            if (args.empty() || args[0][0] == '#') {
+                continue; // blank line or comment
+            }
+
+            Job job = defaults;
+            std::string nested;
+            if (!parseFlags(args, job, nested)) {
+                return false;
+            }
+            _jobs.push_back(job);
+        }
+    }
+
+    for (const Job &job: _jobs) {
+        bool known = false;
+        for (const char* name: ALGORITHMS) {
+            known = known || job.algorithm == name;
+        }
+        if (job.edges.empty() || !known) {
+            std::cerr << (job.edges.empty() ? "Every job needs --edges\n" : "Unknown algorithm " + job.algorithm + "\n");
+            printUsage(std::cerr);
+            return false;
+        }
+        if (!_service && (job.start != 0 || !job.subset.empty())) {
+            std::cerr << "--start and --subset need --workers\n";
+            return false;
+        }
+        if (_service && !SolveService::supports(job.algorithm)) {
+            std::cerr << "Algorithm " << job.algorithm << " cannot run with --workers\n";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Batch::loadGraph(const Job &job, std::unique_ptr<Graph> &graph) {
+    int num_vertex;
+    std::size_t num_edges;
+    bool has_coordinates;
+    if (generator::readBinaryHeader(job.edges, num_vertex, num_edges, has_coordinates)) {
+        graph = std::make_unique<Graph>(has_coordinates);
+        return loader::readBinaryGraph(*graph, job.edges);
+    }
+    graph = std::make_unique<Graph>(!job.nodes.empty());
+    return loader::readGraph(*graph, job.edges, job.nodes);
+}
+
+double Batch::solve(Graph &graph, const Job &job, std::vector<Vertex *> &tsp_path, SolveControl &control) {
+    graph.setDenseMatrixLimit(job.matrix_limit);
+    if (job.algorithm == "bruteforce") {
+        return graph.tspBruteforce(tsp_path, &control);
+    }
+    if (job.algorithm == "triangular") {
+        return graph.triangularApproximation(tsp_path);
+    }
+    if (job.algorithm == "nearest-neighbor") {
+        return graph.tspNearestNeighbor(tsp_path, job.two_opt, &control);
+    }
+    if (job.algorithm == "hilbert") {
+        return graph.tspHilbertCurve(tsp_path, job.two_opt > 0, &control);
+    }
+    if (job.algorithm == "cheapest-insertion") {
+        return graph.tspCheapestInsertion(tsp_path);
+    }
+    if (job.algorithm == "farthest-insertion") {
+        return graph.tspFarthestInsertion(tsp_path);
+    }
+    if (job.algorithm == "ils") {
+        return graph.tspIteratedLocalSearch(tsp_path, job.time_limit, job.threads, &control);
+    }
+    if (job.algorithm == "annealing") {
+        double moves_per_second;
+        return graph.tspSimulatedAnnealing(tsp_path, job.time_limit, job.threads, moves_per_second, &control);
+    }
+    return graph.tspClusterDecomposition(tsp_path, job.cluster_size, job.threads, &control);
+}
+
+int Batch::run() {
+    std::ofstream file;
+    if (!_output.empty()) {
+        file.open(_output);
+        if (!file.is_open()) {
+            std::cerr << "Error opening " << _output << '\n';
+            return 1;
+        }
+    }
+    std::ostream &out = _output.empty() ? std::cout : file;
+    out.precision(10);
+
+    if (!_trace.empty()) {
+        trace::start();
+    }
+    int status = _service ? runOnService(out) : runSequential(out);
+
+    if (!_trace.empty()) {
+        trace::stop();
+        if (!trace::write(_trace)) {
+            std::cerr << "Error writing " << _trace << '\n';
+            status = 1;
+        }
+    }
+    return status;
+}
+
+int Batch::runSequential(std::ostream &out) {
+    std::unique_ptr<Graph> graph;
+    std::string loaded_edges, loaded_nodes;
+    std::size_t num_edges = 0;
+    PerfCounters counters;
+    int status = 0;
+
+    for (std::size_t i = 0; i < _jobs.size(); i++) {
+        const Job &job = _jobs[i];
+        out << "{\"job\":" << i << ",\"edges\":";
+        writeString(out, job.edges);
+        out << ",\"nodes\":";
+        writeString(out, job.nodes);
+        out << ",\"algorithm\":";
+        writeString(out, job.algorithm);
+
+        double load_time = 0; // stays 0 when the graph of the previous job is reused
+        if (graph == nullptr || job.edges != loaded_edges || job.nodes != loaded_nodes) {
+            TRACE_SPAN("load", i);
+            auto start = std::chrono::high_resolution_clock::now();
+            bool loaded = loadGraph(job, graph);
+            std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - start;
+            load_time = duration.count();
+
+            if (!loaded) {
+                graph.reset();
+                out << ",\"error\":\"cannot read the input files\"}" << std::endl;
+                status = 1;
+                continue;
+            }
+            loaded_edges = job.edges;
+            loaded_nodes = job.nodes;
+            if (_perf) {
+                num_edges = countEdges(*graph);
+            }
+        }
+
+        std::vector<Vertex *> tsp_path;
+        INSTRUMENT_RESET();
+        ALLOCATIONS_RESET();
+        auto start = std::chrono::high_resolution_clock::now();
+        double cost;
+        bool measured = _perf && counters.start();
+        SolveControl control(job.deadline);
+        {
+            TRACE_SPAN("solve", i);
+            cost = solve(*graph, job, tsp_path, control);
+            control.flush();
+        }
+        if (measured) {
+            counters.stop();
+        }
+        std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - start;
+
+        TRACE_SPAN("output", i);
+        out << ",\"vertexes\":" << graph->getNumVertex() << ",\"cost\":";
+        writeNumber(out, cost);
+        out << ",\"optimal\":" << (control.isOptimal() ? "true" : "false") << ",\"stopped\":"
+            << (control.isStopped() ? "true" : "false");
+        out << ",\"load_time\":" << load_time << ",\"solve_time\":" << duration.count();
+        if (instrument::ENABLED) {
+            out << ",\"profile\":";
+            instrument::report(out);
+        }
+        if (allocation::ENABLED) {
+            out << ",\"allocations\":";
+            allocation::report(out);
+        }
+        if (_perf) {
+            out << ",\"perf\":";
+            if (measured) {
+                counters.writeJson(out, graph->getNumVertex(), num_edges);
+            } else {
+                out << "{\"error\":\"perf_event_open is not available\"}";
+            }
+        }
+        if (_write_tour) {
+            out << ",\"tour\":[";
+            for (std::size_t j = 0; j < tsp_path.size(); j++) {
+                out << (j > 0 ? "," : "") << tsp_path[j]->getId();
+            }
+            out << ']';
+        }
+        out << '}' << std::endl;
+    }
+
+    return status;
+}
+
+int Batch::runOnService(std::ostream &out) {
+    int status = 0;
+    std::unique_ptr<Graph> graph;
+    std::string loaded_edges, loaded_nodes;
+    for (std::size_t first = 0; first < _jobs.size();) {
+        // the service copies the dense matrix limit of the graph, so a group also shares its --matrix-limit
+        std::size_t last = first + 1;
+        while (last < _jobs.size() && _jobs[last].edges == _jobs[first].edges && _jobs[last].nodes == _jobs[first].nodes
+               && _jobs[last].matrix_limit == _jobs[first].matrix_limit) {
+            last++;
+        }
+
+        double load_time = 0; // stays 0 when the graph of the previous group is reused
+        bool loaded = true;
+        if (graph == nullptr || _jobs[first].edges != loaded_edges || _jobs[first].nodes != loaded_nodes) {
+            TRACE_SPAN("load", first);
+            auto start = std::chrono::high_resolution_clock::now();
+            loaded = loadGraph(_jobs[first], graph);
+            std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - start;
+            load_time = duration.count();
+            if (loaded) {
+                loaded_edges = _jobs[first].edges;
+                loaded_nodes = _jobs[first].nodes;
+            } else {
+                graph.reset();
+            }
+        }
+
+        // every job of the group is queued before the first result is written
+        std::unique_ptr<SolveService> service;
+        std::vector<std::future<SolveService::Result>> results;
+        if (loaded) {
+            graph->setDenseMatrixLimit(_jobs[first].matrix_limit);
+            service = std::make_unique<SolveService>(*graph, _workers);
+            for (std::size_t i = first; i < last; i++) {
+                const Job &job = _jobs[i];
+                SolveService::Request request;
+                request.algorithm = job.algorithm;
+                request.start = job.start;
+                request.vertexes = job.subset;
+                request.two_opt = job.two_opt > 0;
+                request.time_limit = job.time_limit;
+                request.deadline = job.deadline;
+                request.seed = i + 1;
+                results.push_back(service->submit(request));
+            }
+        }
+
+        for (std::size_t i = first; i < last; i++) {
+            const Job &job = _jobs[i];
+            out << "{\"job\":" << i << ",\"edges\":";
+            writeString(out, job.edges);
+            out << ",\"nodes\":";
+            writeString(out, job.nodes);
+            out << ",\"algorithm\":";
+            writeString(out, job.algorithm);
+            out << ",\"start\":" << job.start;
+            if (!loaded) {
+                out << ",\"error\":\"cannot read the input files\"}" << std::endl;
+                status = 1;
+                continue;
+            }
+
+            SolveService::Result result = results[i - first].get();
+            if (!result.error.empty()) {
+                out << ",\"error\":";
+                writeString(out, result.error);
+                out << '}' << std::endl;
+                status = 1;
+                continue;
+            }
+
+            out << ",\"vertexes\":" << result.tour.size() - 1 << ",\"cost\":";
+            writeNumber(out, result.cost);
+            out << ",\"optimal\":" << (result.optimal ? "true" : "false") << ",\"stopped\":"
+                << (result.stopped ? "true" : "false");
+            out << ",\"load_time\":" << (i == first ? load_time : 0) << ",\"solve_time\":" << result.solve_time;
+            if (_write_tour) {
+                out << ",\"tour\":[";
+                for (std::size_t j = 0; j < result.tour.size(); j++) {
+                    out << (j > 0 ? "," : "") << result.tour[j];
+                }
+                out << ']';
+            }
+            out << '}' << std::endl;
+        }
+        first = last;
+    }
+    return status;
+}
@@ -0,0 +1,298 @@
+#include "CompactGraph.h"
+#include "Graph.h"
+#include "ThreadPool.h"
+#include "Trace.h"
+#include "Weight.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+// Lists shorter than this are relaxed on the calling thread, the pool would cost more than the work
+static const std::size_t PARALLEL_THRESHOLD = 1024;
+
+template<class W>
+BasicCompactGraph<W>::BasicCompactGraph(const Graph &graph, double scale) {
+    int n = graph.getNumVertex();
+    std::vector<Vertex *> vertexes(n);
+    for (auto v: graph.getVertexSet()) {
+        vertexes[v.first] = v.second;
+    }
+
+    _offsets.reserve(n + 1);
+    _offsets.push_back(0);
+    for (Vertex* v: vertexes) {
+        for (Edge* e: v->getAdj()) {
+            _targets.push_back(e->getDest()->getId());
+            _weights.push_back(weight::convert<W>(e->getWeight(), scale));
+        }
+        _offsets.push_back(_targets.size());
+    }
+
+    if (graph.isCoordinateMode()) {
+        _longitudes.resize(n);
+        _latitudes.resize(n);
+        for (int i = 0; i < n; i++) {
+            auto llv = static_cast<LongLatVertex *>(vertexes[i]);
+            _longitudes[i] = llv->getLong();
+            _latitudes[i] = llv->getLat();
+        }
+    }
+}
+
+template<class W>
+int BasicCompactGraph<W>::getNumVertex() const {
+    return (int) _offsets.size() - 1;
+}
+
+template<class W>
+std::size_t BasicCompactGraph<W>::getNumEdges() const {
+    return _targets.size();
+}
+
+template<class W>
+bool BasicCompactGraph<W>::hasCoordinates() const {
+    return !_longitudes.empty();
+}
+
+template<class W>
+double BasicCompactGraph<W>::haversine(int u, int v) const {
+    return LongLatVertex::haversine(_longitudes[u], _latitudes[u], _longitudes[v], _latitudes[v]);
+}
+
+template<class W>
+BasicCompactGraph<W> BasicCompactGraph<W>::permute(const std::vector<int> &order) const {
+    int n = getNumVertex();
+    std::vector<int> rank(n);
+    for (int i = 0; i < n; i++) {
+        rank[order[i]] = i;
+    }
+
+    BasicCompactGraph<W> result;
+    result._offsets.reserve(n + 1);
+    result._offsets.push_back(0);
+    result._targets.reserve(_targets.size());
+    result._weights.reserve(_weights.size());
+    result._original_ids.resize(n);
+
+    std::vector<std::pair<int, W>> edges;
+    for (int i = 0; i < n; i++) {
+        int v = order[i];
+        edges.clear();
+        for (int e = _offsets[v]; e < _offsets[v + 1]; e++) {
+            edges.emplace_back(rank[_targets[e]], _weights[e]);
+        }
+        std::sort(edges.begin(), edges.end());
+        for (auto [target, w]: edges) {
+            result._targets.push_back(target);
+            result._weights.push_back(w);
+        }
+        result._offsets.push_back(result._targets.size());
+        result._original_ids[i] = getOriginalId(v);
+    }
+
+    if (hasCoordinates()) {
+        result._longitudes.resize(n);
+        result._latitudes.resize(n);
+        for (int i = 0; i < n; i++) {
+            result._longitudes[i] = _longitudes[order[i]];
+            result._latitudes[i] = _latitudes[order[i]];
+        }
+    }
+
+    return result;
+}
+
+template<class W>
+std::size_t BasicCompactGraph<W>::memoryUsage() const {
+    return _offsets.size() * sizeof(int) + _targets.size() * sizeof(int) + _weights.size() * sizeof(W)
+         + (_longitudes.size() + _latitudes.size()) * sizeof(double) + _original_ids.size() * sizeof(int);
+}
+
+template<class W>
+std::vector<double> BasicCompactGraph<W>::deltaStepping(int source, double delta, ThreadPool &pool) const {
+    const double INF = std::numeric_limits<double>::infinity();
+    int n = getNumVertex();
+
+    if (delta <= 0) {
+        double total = 0;
+        for (W w: _weights) {
+            total += w;
+        }
+        delta = _weights.empty() || total <= 0 ? 1 : total / _weights.size();
+    }
+
+    std::vector<std::atomic<double>> dist(n);
+    for (auto &d: dist) {
+        d.store(INF, std::memory_order_relaxed);
+    }
+
+    std::vector<std::vector<int>> buckets;
+    auto bucket_of = [delta](double d) { return (std::size_t) (d / delta); };
+    auto push = [&](int v, double d) {
+        std::size_t b = bucket_of(d);
+        if (b >= buckets.size()) {
+            buckets.resize(b + 1);
+        }
+        buckets[b].push_back(v);
+    };
+
+    // successful relaxations (vertex, new distance) of each chunk, merged into the buckets after the phase
+    unsigned int num_chunks = pool.size();
+    std::vector<std::vector<std::pair<int, double>>> updates(num_chunks);
+
+    auto relax_chunk = [&](const std::vector<int> &list, bool light, unsigned int chunk) {
+        auto &out = updates[chunk];
+        std::size_t begin = list.size() * chunk / num_chunks;
+        std::size_t end = list.size() * (chunk + 1) / num_chunks;
+        for (std::size_t i = begin; i < end; i++) {
+            int u = list[i];
+            double du = dist[u].load(std::memory_order_relaxed);
+            for (int e = _offsets[u]; e < _offsets[u + 1]; e++) {
+                double w = _weights[e];
+                if ((w <= delta) != light) {
+                    continue;
+                }
+
+                int v = _targets[e];
+                double nd = du + w;
+                double current = dist[v].load(std::memory_order_relaxed);
+                while (nd < current) {
+                    if (dist[v].compare_exchange_weak(current, nd, std::memory_order_relaxed)) {
+                        out.emplace_back(v, nd);
+                        break;
+                    }
+                }
+            }
+        }
+    };
+
+    auto relax = [&](const std::vector<int> &list, bool light) {
+        if (list.size() < PARALLEL_THRESHOLD || num_chunks == 1) {
+            for (unsigned int chunk = 0; chunk < num_chunks; chunk++) {
+                updates[chunk].clear();
+                relax_chunk(list, light, chunk);
+            }
+        } else {
+            std::vector<std::future<void>> done;
+            for (unsigned int chunk = 0; chunk < num_chunks; chunk++) {
+                updates[chunk].clear();
+                done.push_back(pool.submit([&, chunk]() {
+                    TRACE_SPAN("relax-chunk", chunk);
+                    relax_chunk(list, light, chunk);
+                }));
+            }
+            for (auto &d: done) {
+                d.get();
+            }
+        }
+
+        for (auto &out: updates) {
+            for (auto [v, d]: out) {
+                // a later relaxation may have lowered it again, that one is queued instead
+                if (dist[v].load(std::memory_order_relaxed) == d) {
+                    push(v, d);
+                }
+            }
+        }
+    };
+
+    dist[source].store(0, std::memory_order_relaxed);
+    push(source, 0);
+
+    std::vector<int> frontier, settled;
+    std::vector<unsigned int> in_frontier(n, 0), in_settled(n, 0);
+    unsigned int round = 0;
+    for (std::size_t i = 0; i < buckets.size(); i++) {
+        settled.clear();
+        while (!buckets[i].empty()) {
+            round++;
+            frontier.clear();
+            for (int v: buckets[i]) {
+                if (in_frontier[v] != round && bucket_of(dist[v].load(std::memory_order_relaxed)) == i) {
+                    in_frontier[v] = round;
+                    frontier.push_back(v);
+                    if (in_settled[v] != i + 1) {
+                        in_settled[v] = i + 1;
+                        settled.push_back(v);
+                    }
+                }
+            }
+            buckets[i].clear();
+            relax(frontier, true);
+        }
+
+        // heavy edges can only reach later buckets, relax them once with the final distances
+        relax(settled, false);
+    }
+
+    std::vector<double> result(n);
+    for (int v = 0; v < n; v++) {
+        result[v] = dist[v].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+template class BasicCompactGraph<float>;
+template class BasicCompactGraph<int32_t>;
+template class BasicCompactGraph<double>;
+
+std::vector<int64_t> radixHeapDijkstra(const BasicCompactGraph<int32_t> &graph, int source) {
+    const int64_t INF = std::numeric_limits<int64_t>::max();
+    int n = graph.getNumVertex();
+    std::vector<int64_t> dist(n, INF);
+
+    // bucket 0 holds keys equal to last, bucket b keys whose highest bit differing from last is b - 1
+    std::vector<std::pair<uint64_t, int>> buckets[65];
+    uint64_t last = 0;
+    std::size_t size = 0;
+    auto bucket_of = [&last](uint64_t key) { return key == last ? 0 : 64 - __builtin_clzll(key ^ last); };
+    auto push = [&](uint64_t key, int v) {
+        buckets[bucket_of(key)].emplace_back(key, v);
+        size++;
+    };
+
+    dist[source] = 0;
+    push(0, source);
+    while (size > 0) {
+        if (buckets[0].empty()) {
+            int b = 1;
+            while (buckets[b].empty()) {
+                b++;
+            }
+
+            // the new minimum splits bucket b over lower buckets
+            last = buckets[b][0].first;
+            for (auto &item: buckets[b]) {
+                last = std::min(last, item.first);
+            }
+            for (auto &item: buckets[b]) {
+                buckets[bucket_of(item.first)].push_back(item);
+            }
+            buckets[b].clear();
+        }
+
+        auto [key, u] = buckets[0].back();
+        buckets[0].pop_back();
+        size--;
+        if ((int64_t) key != dist[u]) {
+            continue; // outdated entry
+        }
+
+        for (int e = graph.edgesBegin(u); e < graph.edgesEnd(u); e++) {
+            int32_t w = graph.getWeight(e);
+            if (w == weight::infinity<int32_t>()) {
+                continue;
+            }
+
+            int v = graph.getTarget(e);
+            int64_t nd = dist[u] + w;
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                push(nd, v);
+            }
+        }
+    }
+
+    return dist;
+}
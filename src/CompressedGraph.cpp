@@ -0,0 +1,134 @@
+#include "CompressedGraph.h"
+#include "UndirectedGraph.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+
+// Number of distinct quantized weights
+static const double QUANTIZATION_LEVELS = 65535;
+
+void CompressedGraph::writeVarint(uint64_t value) {
+    while (value >= 0x80) {
+        _data.push_back((uint8_t) (value | 0x80));
+        value >>= 7;
+    }
+    _data.push_back((uint8_t) value);
+}
+
+CompressedGraph::CompressedGraph(const UndirectedGraph &graph): _num_edges(graph.getNumEdges()) {
+    int n = graph.getNumVertex();
+
+    double max_weight = 0;
+    _min_weight = std::numeric_limits<double>::infinity();
+    for (std::size_t e = 0; e < graph.getNumEdges(); e++) {
+        _min_weight = std::min(_min_weight, graph.getWeight(e));
+        max_weight = std::max(max_weight, graph.getWeight(e));
+    }
+    if (graph.getNumEdges() == 0) {
+        _min_weight = 0;
+    }
+    _step = (max_weight - _min_weight) / QUANTIZATION_LEVELS;
+
+    std::vector<std::pair<int, double>> neighbors;
+    _offsets.reserve(n + 1);
+    for (int v = 0; v < n; v++) {
+        _offsets.push_back(_data.size());
+
+        neighbors.clear();
+        for (int i = graph.incidentBegin(v); i < graph.incidentEnd(v); i++) {
+            int e = graph.getIncident(i);
+            neighbors.emplace_back(graph.getOther(e, v), graph.getWeight(e));
+        }
+        std::sort(neighbors.begin(), neighbors.end());
+
+        writeVarint(neighbors.size());
+        int previous = 0;
+        for (auto [u, w]: neighbors) {
+            writeVarint(u - previous);
+            previous = u;
+
+            auto q = (uint16_t) (_step > 0 ? std::lround((w - _min_weight) / _step) : 0);
+            _data.push_back((uint8_t) (q & 0xFF));
+            _data.push_back((uint8_t) (q >> 8));
+        }
+    }
+    _offsets.push_back(_data.size());
+    _data.shrink_to_fit();
+}
+
+int CompressedGraph::getNumVertex() const {
+    return _offsets.empty() ? 0 : (int) _offsets.size() - 1;
+}
+
+std::size_t CompressedGraph::getNumEdges() const {
+    return _num_edges;
+}
+
+double CompressedGraph::getMaxError() const {
+    return _step / 2;
+}
+
+std::vector<double> CompressedGraph::dijkstra(int source) const {
+    using Entry = std::pair<double, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> pq;
+
+    std::vector<double> dist(getNumVertex(), std::numeric_limits<double>::infinity());
+    dist[source] = 0;
+    pq.push({0, source});
+    while (!pq.empty()) {
+        auto [d, u] = pq.top();
+        pq.pop();
+        if (d > dist[u]) {
+            continue; // outdated entry
+        }
+
+        forEachNeighbor(u, [&](int v, double w) {
+            if (d + w < dist[v]) {
+                dist[v] = d + w;
+                pq.push({dist[v], v});
+            }
+        });
+    }
+
+    return dist;
+}
+
+double CompressedGraph::prim(int root, std::vector<int> &parent) const {
+    using Entry = std::pair<double, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> pq;
+
+    int n = getNumVertex();
+    std::vector<double> key(n, std::numeric_limits<double>::infinity());
+    std::vector<bool> in_tree(n, false);
+    parent.assign(n, -1);
+
+    double cost = 0;
+    key[root] = 0;
+    pq.push({0, root});
+    while (!pq.empty()) {
+        auto [k, u] = pq.top();
+        pq.pop();
+        if (in_tree[u]) {
+            continue; // outdated entry
+        }
+        in_tree[u] = true;
+        cost += k;
+
+        forEachNeighbor(u, [&](int v, double w) {
+            if (!in_tree[v] && w < key[v]) {
+                key[v] = w;
+                parent[v] = u;
+                pq.push({w, v});
+            }
+        });
+    }
+
+    return cost;
+}
+
+std::size_t CompressedGraph::memoryUsage() const {
+    return _data.size() + _offsets.size() * sizeof(uint64_t);
+}
@@ -0,0 +1,491 @@
+#include "ContractionHierarchy.h"
+#include "Graph.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <queue>
+
+static const double INF = std::numeric_limits<double>::infinity();
+
+// Vertexes a witness search may settle before giving up (a missed witness only adds an unneeded shortcut)
+static const int WITNESS_SETTLE_LIMIT = 500;
+
+// File header of a saved hierarchy
+static const char MAGIC[8] = {'F', 'D', 'A', '2', 'C', 'H', '\0', '\0'};
+static const uint32_t FORMAT_VERSION = 2;
+
+using Entry = std::pair<double, int>;
+using MinQueue = std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>;
+
+// Edge of the graph being contracted
+struct Arc {
+    int to;
+    double weight;
+};
+
+// Add an arc, or lower the weight of the existing one to the same vertex
+static void addArc(std::vector<Arc> &arcs, int to, double weight) {
+    for (Arc &arc: arcs) {
+        if (arc.to == to) {
+            arc.weight = std::min(arc.weight, weight);
+            return;
+        }
+    }
+    arcs.push_back({to, weight});
+}
+
+static void removeArc(std::vector<Arc> &arcs, int to) {
+    for (std::size_t i = 0; i < arcs.size(); i++) {
+        if (arcs[i].to == to) {
+            arcs[i] = arcs.back();
+            arcs.pop_back();
+            return;
+        }
+    }
+}
+
+// Bounded Dijkstra over the vertexes not contracted yet, looking for a path that makes a shortcut unnecessary
+class WitnessSearch {
+private:
+    std::vector<double> _dist;
+    std::vector<int> _touched;
+
+public:
+    explicit WitnessSearch(int size): _dist(size, INF) {}
+
+    void run(const std::vector<std::vector<Arc>> &out, int source, int skip, double max_dist) {
+        for (int v: _touched) {
+            _dist[v] = INF;
+        }
+        _touched.clear();
+
+        MinQueue pq;
+        _dist[source] = 0;
+        _touched.push_back(source);
+        pq.push({0, source});
+
+        int settled = 0;
+        while (!pq.empty()) {
+            auto [d, u] = pq.top();
+            pq.pop();
+            if (d > _dist[u]) {
+                continue;
+            }
+            if (d > max_dist || ++settled > WITNESS_SETTLE_LIMIT) {
+                break;
+            }
+
+            for (const Arc &arc: out[u]) {
+                if (arc.to == skip) {
+                    continue;
+                }
+                double nd = d + arc.weight;
+                if (nd < _dist[arc.to]) {
+                    if (_dist[arc.to] == INF) {
+                        _touched.push_back(arc.to);
+                    }
+                    _dist[arc.to] = nd;
+                    pq.push({nd, arc.to});
+                }
+            }
+        }
+    }
+
+    double get(int v) const {
+        return _dist[v];
+    }
+};
+
+// Shortcuts needed to contract v, added to the graph unless simulating
+static int contract(int v, std::vector<std::vector<Arc>> &out, std::vector<std::vector<Arc>> &in,
+                    WitnessSearch &witness, bool simulate) {
+    struct Shortcut {
+        int from;
+        int to;
+        double weight;
+    };
+    std::vector<Shortcut> shortcuts;
+
+    for (const Arc &in_arc: in[v]) {
+        int u = in_arc.to;
+        double max_dist = -1;
+        for (const Arc &out_arc: out[v]) {
+            if (out_arc.to != u) {
+                max_dist = std::max(max_dist, in_arc.weight + out_arc.weight);
+            }
+        }
+        if (max_dist < 0) {
+            continue;
+        }
+
+        witness.run(out, u, v, max_dist);
+        for (const Arc &out_arc: out[v]) {
+            double via = in_arc.weight + out_arc.weight;
+            if (out_arc.to != u && witness.get(out_arc.to) > via) {
+                shortcuts.push_back({u, out_arc.to, via});
+            }
+        }
+    }
+
+    if (!simulate) {
+        for (const Shortcut &s: shortcuts) {
+            addArc(out[s.from], s.to, s.weight);
+            addArc(in[s.to], s.from, s.weight);
+        }
+    }
+
+    return shortcuts.size();
+}
+
+// Flatten adjacency lists into offsets/targets/weights
+static void toCsr(const std::vector<std::vector<Arc>> &lists, std::vector<int> &offsets,
+                  std::vector<int> &targets, std::vector<double> &weights) {
+    offsets.assign(1, 0);
+    targets.clear();
+    weights.clear();
+    for (const auto &list: lists) {
+        for (const Arc &arc: list) {
+            targets.push_back(arc.to);
+            weights.push_back(arc.weight);
+        }
+        offsets.push_back(targets.size());
+    }
+}
+
+uint64_t ContractionHierarchy::fingerprint(const Graph &graph) {
+    // FNV-1a over the vertex count and every edge (destination and weight bits) in vertex id order
+    uint64_t hash = 0xCBF29CE484222325ull;
+    auto mix = [&hash](uint64_t value) {
+        for (int byte = 0; byte < 8; byte++) {
+            hash = (hash ^ ((value >> (8 * byte)) & 0xFF)) * 0x100000001B3ull;
+        }
+    };
+
+    mix(graph.getNumVertex());
+    for (int id = 0; id < graph.getNumVertex(); id++) {
+        Vertex* v = graph.findVertex(id);
+        if (v == nullptr) {
+            mix(UINT64_MAX);
+            continue;
+        }
+        mix(v->getAdj().size());
+        for (Edge* e: v->getAdj()) {
+            uint64_t weight_bits;
+            double weight = e->getWeight();
+            std::memcpy(&weight_bits, &weight, sizeof(weight));
+            mix(e->getDest()->getId());
+            mix(weight_bits);
+        }
+    }
+    return hash;
+}
+
+bool ContractionHierarchy::isSparse(const Graph &graph) {
+    std::size_t num_edges = 0;
+    for (auto v: graph.getVertexSet()) {
+        num_edges += v.second->getAdj().size();
+    }
+    return num_edges <= MAX_AVERAGE_DEGREE * graph.getNumVertex();
+}
+
+ContractionHierarchy::ContractionHierarchy(const Graph &graph)
+    : _size(graph.getNumVertex()), _fingerprint(fingerprint(graph)) {
+    std::vector<std::vector<Arc>> out(_size), in(_size);
+    for (auto v: graph.getVertexSet()) {
+        for (Edge* e: v.second->getAdj()) {
+            int dest = e->getDest()->getId();
+            if (dest != v.first) {
+                addArc(out[v.first], dest, e->getWeight());
+                addArc(in[dest], v.first, e->getWeight());
+            }
+        }
+    }
+
+    WitnessSearch witness(_size);
+    std::vector<int> deleted_neighbors(_size, 0);
+    auto priority = [&](int v) {
+        int edge_difference = contract(v, out, in, witness, true) - (int) (in[v].size() + out[v].size());
+        return (double) (edge_difference + deleted_neighbors[v]);
+    };
+
+    MinQueue pq;
+    for (int v = 0; v < _size; v++) {
+        pq.push({priority(v), v});
+    }
+
+    std::vector<std::vector<Arc>> up_out(_size), up_in(_size);
+    while (!pq.empty()) {
+        int v = pq.top().second;
+        pq.pop();
+
+        // lazy update, the priority may have grown since it was queued
+        double current = priority(v);
+        if (!pq.empty() && current > pq.top().first) {
+            pq.push({current, v});
+            continue;
+        }
+
+        contract(v, out, in, witness, false);
+
+        // every remaining neighbor is contracted later, so these edges all go upward
+        up_out[v] = out[v];
+        up_in[v] = in[v];
+        for (const Arc &arc: out[v]) {
+            removeArc(in[arc.to], v);
+            deleted_neighbors[arc.to]++;
+        }
+        for (const Arc &arc: in[v]) {
+            removeArc(out[arc.to], v);
+            deleted_neighbors[arc.to]++;
+        }
+        out[v].clear();
+        in[v].clear();
+    }
+
+    toCsr(up_out, _fwd_offsets, _fwd_targets, _fwd_weights);
+    toCsr(up_in, _bwd_offsets, _bwd_targets, _bwd_weights);
+    for (int side = 0; side < 2; side++) {
+        _dist[side].assign(_size, INF);
+    }
+}
+
+void ContractionHierarchy::clearSearch(int side) {
+    for (int v: _touched[side]) {
+        _dist[side][v] = INF;
+    }
+    _touched[side].clear();
+}
+
+void ContractionHierarchy::upwardSearch(int source, bool forward, std::vector<std::pair<int, double>> &settled) {
+    int side = forward ? 0 : 1;
+    const auto &offsets = forward ? _fwd_offsets : _bwd_offsets;
+    const auto &targets = forward ? _fwd_targets : _bwd_targets;
+    const auto &weights = forward ? _fwd_weights : _bwd_weights;
+    auto &dist = _dist[side];
+
+    clearSearch(side);
+    settled.clear();
+
+    MinQueue pq;
+    dist[source] = 0;
+    _touched[side].push_back(source);
+    pq.push({0, source});
+    while (!pq.empty()) {
+        auto [d, u] = pq.top();
+        pq.pop();
+        if (d > dist[u]) {
+            continue;
+        }
+        settled.emplace_back(u, d);
+
+        for (int i = offsets[u]; i < offsets[u + 1]; i++) {
+            int v = targets[i];
+            double nd = d + weights[i];
+            if (nd < dist[v]) {
+                if (dist[v] == INF) {
+                    _touched[side].push_back(v);
+                }
+                dist[v] = nd;
+                pq.push({nd, v});
+            }
+        }
+    }
+}
+
+double ContractionHierarchy::query(int source, int dest) {
+    if (source == dest) {
+        return 0;
+    }
+
+    std::vector<std::pair<int, double>> settled;
+    upwardSearch(source, true, settled);
+
+    // backward search meets the forward search space at the most important vertex of the shortest path
+    auto &dist = _dist[1];
+    clearSearch(1);
+    MinQueue pq;
+    dist[dest] = 0;
+    _touched[1].push_back(dest);
+    pq.push({0, dest});
+
+    double best = INF;
+    while (!pq.empty()) {
+        auto [d, u] = pq.top();
+        pq.pop();
+        if (d > dist[u]) {
+            continue;
+        }
+        if (d >= best) {
+            break;
+        }
+        best = std::min(best, d + _dist[0][u]);
+
+        for (int i = _bwd_offsets[u]; i < _bwd_offsets[u + 1]; i++) {
+            int v = _bwd_targets[i];
+            double nd = d + _bwd_weights[i];
+            if (nd < dist[v]) {
+                if (dist[v] == INF) {
+                    _touched[1].push_back(v);
+                }
+                dist[v] = nd;
+                pq.push({nd, v});
+            }
+        }
+    }
+
+    return best;
+}
+
+std::vector<std::vector<double>> ContractionHierarchy::manyToMany(const std::vector<int> &sources, const std::vector<int> &targets) {
+    std::vector<std::vector<double>> table(sources.size(), std::vector<double>(targets.size(), INF));
+    std::vector<std::vector<std::pair<int, double>>> buckets(_size);
+    std::vector<std::pair<int, double>> settled;
+
+    for (std::size_t j = 0; j < targets.size(); j++) {
+        upwardSearch(targets[j], false, settled);
+        for (auto [v, d]: settled) {
+            buckets[v].emplace_back(j, d);
+        }
+    }
+
+    for (std::size_t i = 0; i < sources.size(); i++) {
+        upwardSearch(sources[i], true, settled);
+        std::vector<double> &row = table[i];
+        for (auto [v, d]: settled) {
+            for (auto [j, target_dist]: buckets[v]) {
+                row[j] = std::min(row[j], d + target_dist);
+            }
+        }
+    }
+
+    return table;
+}
+
+DistanceMatrix ContractionHierarchy::distanceTable(const std::vector<int> &vertexes) {
+    std::vector<std::vector<double>> table = manyToMany(vertexes, vertexes);
+    DistanceMatrix dist(vertexes.size());
+    for (std::size_t i = 0; i < vertexes.size(); i++) {
+        for (std::size_t j = 0; j < vertexes.size(); j++) {
+            dist.set(i, j, table[i][j]);
+        }
+    }
+    return dist;
+}
+
+template <class T>
+static void writeVector(std::ofstream &file, const std::vector<T> &v) {
+    uint64_t size = v.size();
+    file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+    file.write(reinterpret_cast<const char *>(v.data()), size * sizeof(T));
+}
+
+template <class T>
+static bool readVector(std::ifstream &file, std::vector<T> &v, uint64_t file_size) {
+    uint64_t size;
+    if (!file.read(reinterpret_cast<char *>(&size), sizeof(size))) {
+        return false;
+    }
+    // a corrupted size must not allocate more than the rest of the file can hold
+    if (size > (file_size - (uint64_t) file.tellg()) / sizeof(T)) {
+        return false;
+    }
+    v.resize(size);
+    return (bool) file.read(reinterpret_cast<char *>(v.data()), size * sizeof(T));
+}
+
+// If offsets/targets are a valid CSR layout over size vertexes
+static bool validCsr(const std::vector<int> &offsets, const std::vector<int> &targets, int32_t size) {
+    if (offsets.size() != (std::size_t) size + 1 || offsets.front() != 0
+        || (std::size_t) offsets.back() != targets.size()) {
+        return false;
+    }
+    for (int32_t v = 0; v < size; v++) {
+        if (offsets[v] > offsets[v + 1]) {
+            return false;
+        }
+    }
+    for (int target: targets) {
+        if (target < 0 || target >= size) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ContractionHierarchy::save(const std::string &path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    int32_t size = _size;
+    file.write(MAGIC, sizeof(MAGIC));
+    file.write(reinterpret_cast<const char *>(&FORMAT_VERSION), sizeof(FORMAT_VERSION));
+    file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+    file.write(reinterpret_cast<const char *>(&_fingerprint), sizeof(_fingerprint));
+    writeVector(file, _fwd_offsets);
+    writeVector(file, _fwd_targets);
+    writeVector(file, _fwd_weights);
+    writeVector(file, _bwd_offsets);
+    writeVector(file, _bwd_targets);
+    writeVector(file, _bwd_weights);
+
+    return (bool) file;
+}
+
+bool ContractionHierarchy::load(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file.seekg(0, std::ios::end);
+    uint64_t file_size = (uint64_t) file.tellg();
+    file.seekg(0, std::ios::beg);
+
+    char magic[sizeof(MAGIC)];
+    uint32_t version;
+    int32_t size;
+    uint64_t graph_fingerprint;
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0
+        || !file.read(reinterpret_cast<char *>(&version), sizeof(version)) || version != FORMAT_VERSION
+        || !file.read(reinterpret_cast<char *>(&size), sizeof(size)) || size < 0
+        || !file.read(reinterpret_cast<char *>(&graph_fingerprint), sizeof(graph_fingerprint))) {
+        return false;
+    }
+
+    ContractionHierarchy loaded;
+    loaded._size = size;
+    loaded._fingerprint = graph_fingerprint;
+    if (!readVector(file, loaded._fwd_offsets, file_size) || !readVector(file, loaded._fwd_targets, file_size)
+        || !readVector(file, loaded._fwd_weights, file_size) || !readVector(file, loaded._bwd_offsets, file_size)
+        || !readVector(file, loaded._bwd_targets, file_size) || !readVector(file, loaded._bwd_weights, file_size)) {
+        return false;
+    }
+
+    if (!validCsr(loaded._fwd_offsets, loaded._fwd_targets, size) || !validCsr(loaded._bwd_offsets, loaded._bwd_targets, size)
+        || loaded._fwd_weights.size() != loaded._fwd_targets.size() || loaded._bwd_weights.size() != loaded._bwd_targets.size()) {
+        return false;
+    }
+
+    for (int side = 0; side < 2; side++) {
+        loaded._dist[side].assign(size, INF);
+    }
+    *this = std::move(loaded);
+    return true;
+}
+
+uint64_t ContractionHierarchy::getFingerprint() const {
+    return _fingerprint;
+}
+
+int ContractionHierarchy::getNumVertex() const {
+    return _size;
+}
+
+std::size_t ContractionHierarchy::getNumEdges() const {
+    return _fwd_targets.size() + _bwd_targets.size();
+}
@@ -0,0 +1,89 @@
+#include "DistanceMatrix.h"
+#include "CompactGraph.h"
+#include "Trace.h"
+#include "UndirectedGraph.h"
+
+template<class W>
+BasicDistanceMatrix<W>::BasicDistanceMatrix(std::size_t size)
+    : _size(size), _weights(size * size, weight::infinity<W>()) {
+    for (std::size_t i = 0; i < size; i++) {
+        _weights[i * size + i] = 0;
+    }
+}
+
+template<class W>
+BasicDistanceMatrix<W>::BasicDistanceMatrix(const Graph &graph, double scale)
+    : BasicDistanceMatrix(CompactGraph(graph), scale) {}
+
+template<class W>
+BasicDistanceMatrix<W>::BasicDistanceMatrix(const BasicCompactGraph<double> &graph, double scale)
+    : BasicDistanceMatrix(graph.getNumVertex()) {
+    TRACE_SPAN("distance-matrix");
+    for (int i = 0; i < graph.getNumVertex(); i++) {
+        for (int e = graph.edgesBegin(i); e < graph.edgesEnd(i); e++) {
+            set(i, graph.getTarget(e), weight::convert<W>(graph.getWeight(e), scale));
+        }
+    }
+
+    if (!graph.hasCoordinates()) {
+        return;
+    }
+
+    for (std::size_t i = 0; i < _size; i++) {
+        for (std::size_t j = i + 1; j < _size; j++) {
+            if (_weights[i * _size + j] == weight::infinity<W>()) {
+                W distance = weight::convert<W>(graph.haversine(i, j), scale);
+                _weights[i * _size + j] = distance;
+                _weights[j * _size + i] = distance;
+            }
+        }
+    }
+}
+
+template<class W>
+BasicDistanceMatrix<W>::BasicDistanceMatrix(const UndirectedGraph &graph, double scale)
+    : BasicDistanceMatrix(graph.getNumVertex()) {
+    for (int u = 0; u < graph.getNumVertex(); u++) {
+        for (int i = graph.incidentBegin(u); i < graph.incidentEnd(u); i++) {
+            int e = graph.getIncident(i);
+            set(u, graph.getOther(e, u), weight::convert<W>(graph.getWeight(e), scale));
+        }
+    }
+
+    if (!graph.hasCoordinates()) {
+        return;
+    }
+
+    for (std::size_t i = 0; i < _size; i++) {
+        for (std::size_t j = i + 1; j < _size; j++) {
+            if (_weights[i * _size + j] == weight::infinity<W>()) {
+                W distance = weight::convert<W>(graph.haversine(i, j), scale);
+                _weights[i * _size + j] = distance;
+                _weights[j * _size + i] = distance;
+            }
+        }
+    }
+}
+
+template<class W>
+void BasicDistanceMatrix<W>::set(std::size_t i, std::size_t j, W weight) {
+    _weights[i * _size + j] = weight;
+}
+
+template<class W>
+std::size_t BasicDistanceMatrix<W>::size() const {
+    return _size;
+}
+
+template<class W>
+double BasicDistanceMatrix<W>::tourCost(const std::vector<int> &tour) const {
+    double cost = 0;
+    for (std::size_t i = 0; i < tour.size(); i++) {
+        cost += weight::toDouble((*this)(tour[i], tour[(i + 1) % tour.size()]));
+    }
+    return cost;
+}
+
+template class BasicDistanceMatrix<float>;
+template class BasicDistanceMatrix<int32_t>;
+template class BasicDistanceMatrix<double>;
@@ -0,0 +1,464 @@
+#include "Generator.h"
+#include "LocalSearch.h"
+#include "VertexEdge.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
+
+static const char MAGIC[8] = {'F', 'D', 'A', '2', 'G', 'R', '\0', '\0'};
+static const uint32_t FORMAT_VERSION = 1;
+static const uint32_t FLAG_COORDINATES = 1;
+static const std::size_t HEADER_SIZE = 32;
+
+// Side of the square of the planar instances
+static const double PLANE_SIDE = 1000;
+
+// Longitude and latitude box of the geographic instances (mainland Portugal)
+static const double MIN_LONG = -9.5, MAX_LONG = -6.2;
+static const double MIN_LAT = 37.0, MAX_LAT = 42.1;
+
+// Corner and block size (about 100m) of the grid instances
+static const double GRID_LONG = -9.2, GRID_LAT = 38.7;
+static const double GRID_STEP = 0.0009;
+
+// Standard normal sample (Box-Muller)
+static double normal(localsearch::Random &rng) {
+    double u = 1 - rng.uniform(); // in (0, 1], log(0) is undefined
+    return std::sqrt(-2 * std::log(u)) * std::cos(2 * M_PI * rng.uniform());
+}
+
+// Edges of every pair of vertexes
+static void completeEdges(generator::Instance &instance, const std::function<double(int, int)> &weight) {
+    int n = instance.num_vertex;
+    std::size_t m = (std::size_t) n * (n - 1) / 2;
+    instance.origins.reserve(m);
+    instance.dests.reserve(m);
+    instance.weights.reserve(m);
+
+    for (int u = 0; u < n; u++) {
+        for (int v = u + 1; v < n; v++) {
+            instance.origins.push_back(u);
+            instance.dests.push_back(v);
+            instance.weights.push_back(weight(u, v));
+        }
+    }
+}
+
+// Edges from every vertex to its k nearest vertexes (by planar distance), each pair stored once.
+// Points are bucketed in a grid of about two points per cell and each search scans rings of cells around the point
+// until no unseen cell can be closer than the k-th neighbor found.
+static void nearestEdges(generator::Instance &instance, const std::vector<double> &xs, const std::vector<double> &ys,
+                         unsigned int k, const std::function<double(int, int)> &weight) {
+    int n = instance.num_vertex;
+    k = std::min<unsigned int>(k, n > 0 ? n - 1 : 0);
+    if (k == 0) {
+        return;
+    }
+
+    double min_x = *std::min_element(xs.begin(), xs.end()), max_x = *std::max_element(xs.begin(), xs.end());
+    double min_y = *std::min_element(ys.begin(), ys.end()), max_y = *std::max_element(ys.begin(), ys.end());
+    int side = std::max(1, (int) std::sqrt(n / 2.0));
+    double cell = std::max(std::max(max_x - min_x, max_y - min_y) / side, 1e-12);
+
+    auto cellOf = [&](double value, double min) { return std::min(side - 1, (int) ((value - min) / cell)); };
+
+    // counting sort of the points by cell
+    std::vector<int> cell_start((std::size_t) side * side + 1, 0);
+    std::vector<int> point_cell(n);
+    for (int i = 0; i < n; i++) {
+        point_cell[i] = cellOf(ys[i], min_y) * side + cellOf(xs[i], min_x);
+        cell_start[point_cell[i] + 1]++;
+    }
+    for (std::size_t c = 0; c + 1 < cell_start.size(); c++) {
+        cell_start[c + 1] += cell_start[c];
+    }
+    std::vector<int> cell_points(n);
+    std::vector<int> fill(cell_start.begin(), cell_start.end() - 1);
+    for (int i = 0; i < n; i++) {
+        cell_points[fill[point_cell[i]]++] = i;
+    }
+
+    std::vector<int> knn((std::size_t) n * k);
+    std::vector<std::pair<double, int>> best; // sorted by distance, at most k
+    best.reserve(k + 1);
+    for (int u = 0; u < n; u++) {
+        best.clear();
+        int cx = point_cell[u] % side, cy = point_cell[u] / side;
+
+        for (int r = 0; r < side; r++) {
+            for (int y = cy - r; y <= cy + r; y++) {
+                if (y < 0 || y >= side) {
+                    continue;
+                }
+                // only the border of the ring is new
+                int step = (y == cy - r || y == cy + r) ? 1 : 2 * r;
+                for (int x = cx - r; x <= cx + r; x += step) {
+                    if (x < 0 || x >= side) {
+                        continue;
+                    }
+                    int c = y * side + x;
+                    for (int i = cell_start[c]; i < cell_start[c + 1]; i++) {
+                        int v = cell_points[i];
+                        if (v == u) {
+                            continue;
+                        }
+                        double dx = xs[u] - xs[v], dy = ys[u] - ys[v];
+                        double d = dx * dx + dy * dy;
+                        if (best.size() == k && d >= best.back().first) {
+                            continue;
+                        }
+                        best.insert(std::upper_bound(best.begin(), best.end(), std::make_pair(d, v)), {d, v});
+                        if (best.size() > k) {
+                            best.pop_back();
+                        }
+                    }
+                }
+            }
+
+            // every point outside the rings scanned is at least r cells away
+            double reach = r * cell;
+            if (best.size() == k && reach * reach >= best.back().first) {
+                break;
+            }
+        }
+
+        for (unsigned int j = 0; j < k; j++) {
+            knn[(std::size_t) u * k + j] = best[j].second;
+        }
+    }
+
+    // u-v is stored by the lower vertex, or by u when u is not a neighbor of v
+    for (int u = 0; u < n; u++) {
+        for (unsigned int j = 0; j < k; j++) {
+            int v = knn[(std::size_t) u * k + j];
+            if (u > v) {
+                auto first = knn.begin() + (std::ptrdiff_t) v * k;
+                if (std::find(first, first + k, u) != first + k) {
+                    continue;
+                }
+            }
+            instance.origins.push_back(u);
+            instance.dests.push_back(v);
+            instance.weights.push_back(weight(u, v));
+        }
+    }
+}
+
+// Planar instance from its points
+static generator::Instance planar(const std::vector<double> &xs, const std::vector<double> &ys, unsigned int neighbors) {
+    generator::Instance instance;
+    instance.num_vertex = (int) xs.size();
+    auto euclidean = [&](int u, int v) { return std::hypot(xs[u] - xs[v], ys[u] - ys[v]); };
+
+    if (neighbors == 0) {
+        completeEdges(instance, euclidean);
+    } else {
+        nearestEdges(instance, xs, ys, neighbors, euclidean);
+    }
+    return instance;
+}
+
+bool generator::Instance::hasCoordinates() const {
+    return !longitudes.empty();
+}
+
+std::size_t generator::Instance::getNumEdges() const {
+    return origins.size();
+}
+
+generator::Instance generator::uniform(int num_vertex, uint64_t seed, unsigned int neighbors) {
+    localsearch::Random rng(seed);
+    std::vector<double> xs(num_vertex), ys(num_vertex);
+    for (int i = 0; i < num_vertex; i++) {
+        xs[i] = rng.uniform() * PLANE_SIDE;
+        ys[i] = rng.uniform() * PLANE_SIDE;
+    }
+    return planar(xs, ys, neighbors);
+}
+
+generator::Instance generator::clustered(int num_vertex, uint64_t seed, unsigned int neighbors, unsigned int clusters) {
+    localsearch::Random rng(seed);
+    if (clusters == 0) {
+        clusters = std::max(1, num_vertex / 100);
+    }
+
+    std::vector<double> center_xs(clusters), center_ys(clusters);
+    for (unsigned int c = 0; c < clusters; c++) {
+        center_xs[c] = rng.uniform() * PLANE_SIDE;
+        center_ys[c] = rng.uniform() * PLANE_SIDE;
+    }
+
+    // spread chosen so neighboring clusters barely overlap
+    double sigma = PLANE_SIDE / (4 * std::sqrt((double) clusters));
+    std::vector<double> xs(num_vertex), ys(num_vertex);
+    for (int i = 0; i < num_vertex; i++) {
+        unsigned int c = rng.below(clusters);
+        xs[i] = center_xs[c] + normal(rng) * sigma;
+        ys[i] = center_ys[c] + normal(rng) * sigma;
+    }
+    return planar(xs, ys, neighbors);
+}
+
+generator::Instance generator::grid(int num_vertex, uint64_t seed) {
+    const double jitter = 0.3;         // fraction of a block each intersection may move
+    const double keep_vertical = 0.75; // probability of a street between rows (the first column always has one)
+    const double diagonal = 0.05;      // probability of a diagonal street
+    const double detour = 0.3;         // maximum extra length of a street over the straight line
+
+    localsearch::Random rng(seed);
+    Instance instance;
+    instance.num_vertex = num_vertex;
+    instance.longitudes.resize(num_vertex);
+    instance.latitudes.resize(num_vertex);
+
+    int width = std::max(1, (int) std::ceil(std::sqrt((double) num_vertex)));
+    double step_long = GRID_STEP / std::cos(GRID_LAT * M_PI / 180);
+    for (int i = 0; i < num_vertex; i++) {
+        int row = i / width, col = i % width;
+        instance.longitudes[i] = GRID_LONG + (col + jitter * (2 * rng.uniform() - 1)) * step_long;
+        instance.latitudes[i] = GRID_LAT + (row + jitter * (2 * rng.uniform() - 1)) * GRID_STEP;
+    }
+
+    auto addStreet = [&](int u, int v) {
+        double straight = LongLatVertex::haversine(instance.longitudes[u], instance.latitudes[u],
+                                                   instance.longitudes[v], instance.latitudes[v]);
+        instance.origins.push_back(u);
+        instance.dests.push_back(v);
+        instance.weights.push_back(straight * (1 + detour * rng.uniform()));
+    };
+
+    for (int i = 0; i < num_vertex; i++) {
+        int col = i % width;
+        if (col + 1 < width && i + 1 < num_vertex) {
+            addStreet(i, i + 1);
+        }
+        if (i + width < num_vertex && (col == 0 || rng.uniform() < keep_vertical)) {
+            addStreet(i, i + width);
+        }
+        if (col + 1 < width && i + width + 1 < num_vertex && rng.uniform() < diagonal) {
+            addStreet(i, i + width + 1);
+        }
+    }
+
+    return instance;
+}
+
+generator::Instance generator::geographic(int num_vertex, uint64_t seed, unsigned int neighbors) {
+    localsearch::Random rng(seed);
+    std::vector<double> longitudes(num_vertex), latitudes(num_vertex);
+    for (int i = 0; i < num_vertex; i++) {
+        longitudes[i] = MIN_LONG + rng.uniform() * (MAX_LONG - MIN_LONG);
+        latitudes[i] = MIN_LAT + rng.uniform() * (MAX_LAT - MIN_LAT);
+    }
+
+    Instance instance;
+    instance.num_vertex = num_vertex;
+    auto haversine = [&](int u, int v) {
+        return LongLatVertex::haversine(longitudes[u], latitudes[u], longitudes[v], latitudes[v]);
+    };
+
+    if (neighbors == 0) {
+        completeEdges(instance, haversine);
+    } else {
+        // the neighbors are searched on a plane with the longitude scaled to the middle latitude
+        double scale = std::cos((MIN_LAT + MAX_LAT) / 2 * M_PI / 180);
+        std::vector<double> xs(num_vertex);
+        for (int i = 0; i < num_vertex; i++) {
+            xs[i] = longitudes[i] * scale;
+        }
+        nearestEdges(instance, xs, latitudes, neighbors, haversine);
+    }
+
+    instance.longitudes = std::move(longitudes);
+    instance.latitudes = std::move(latitudes);
+    return instance;
+}
+
+// Buffered text output, std::to_chars keeps the shortest representation that reads back exactly
+class CsvWriter {
+private:
+    std::ofstream &_out;
+    std::string _buffer;
+
+public:
+    explicit CsvWriter(std::ofstream &out): _out(out) {
+        _buffer.reserve(1 << 20);
+    }
+
+    ~CsvWriter() {
+        flush();
+    }
+
+    template<class T>
+    CsvWriter &operator<<(T value) {
+        char text[32];
+        auto result = std::to_chars(text, text + sizeof(text), value);
+        _buffer.append(text, result.ptr);
+        return *this;
+    }
+
+    CsvWriter &operator<<(char c) {
+        _buffer.push_back(c);
+        if (_buffer.size() >= (1 << 20)) {
+            flush();
+        }
+        return *this;
+    }
+
+    void flush() {
+        _out.write(_buffer.data(), (std::streamsize) _buffer.size());
+        _buffer.clear();
+    }
+};
+
+bool generator::writeCsv(const Instance &instance, const std::string &edges_file, const std::string &nodes_file) {
+    std::ofstream edges(edges_file, std::ios::binary);
+    if (!edges.is_open()) {
+        return false;
+    }
+
+    edges << "origem,destino,distancia\n";
+    {
+        CsvWriter writer(edges);
+        for (std::size_t e = 0; e < instance.getNumEdges(); e++) {
+            writer << instance.origins[e] << ',' << instance.dests[e] << ',' << instance.weights[e] << '\n';
+        }
+    }
+    if (!edges.good()) {
+        return false;
+    }
+
+    if (!instance.hasCoordinates()) {
+        return true;
+    }
+
+    std::ofstream nodes(nodes_file, std::ios::binary);
+    if (!nodes.is_open()) {
+        return false;
+    }
+
+    nodes << "id,longitude,latitude\n";
+    {
+        CsvWriter writer(nodes);
+        for (int i = 0; i < instance.num_vertex; i++) {
+            writer << i << ',' << instance.longitudes[i] << ',' << instance.latitudes[i] << '\n';
+        }
+    }
+    return nodes.good();
+}
+
+bool generator::writeBinary(const Instance &instance, const std::string &path) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    uint32_t flags = instance.hasCoordinates() ? FLAG_COORDINATES : 0;
+    uint64_t num_vertex = instance.num_vertex, num_edges = instance.getNumEdges();
+    char header[HEADER_SIZE] = {};
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    std::memcpy(header + 8, &FORMAT_VERSION, sizeof(FORMAT_VERSION));
+    std::memcpy(header + 12, &flags, sizeof(flags));
+    std::memcpy(header + 16, &num_vertex, sizeof(num_vertex));
+    std::memcpy(header + 24, &num_edges, sizeof(num_edges));
+    file.write(header, HEADER_SIZE);
+
+    auto writeArray = [&](const auto &values) {
+        file.write(reinterpret_cast<const char *>(values.data()), (std::streamsize) (values.size() * sizeof(values[0])));
+    };
+    if (instance.hasCoordinates()) {
+        writeArray(instance.longitudes);
+        writeArray(instance.latitudes);
+    }
+    writeArray(instance.origins);
+    writeArray(instance.dests);
+    writeArray(instance.weights);
+
+    return file.good();
+}
+
+// Read and check the header of a binary instance
+static bool readHeader(std::ifstream &file, uint64_t &num_vertex, uint64_t &num_edges, uint32_t &flags) {
+    char header[HEADER_SIZE];
+    uint32_t version;
+    if (!file.read(header, HEADER_SIZE) || std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0) {
+        return false;
+    }
+
+    std::memcpy(&version, header + 8, sizeof(version));
+    std::memcpy(&flags, header + 12, sizeof(flags));
+    std::memcpy(&num_vertex, header + 16, sizeof(num_vertex));
+    std::memcpy(&num_edges, header + 24, sizeof(num_edges));
+    return version == FORMAT_VERSION && num_vertex <= (uint64_t) INT32_MAX;
+}
+
+bool generator::readBinaryHeader(const std::string &path, int &num_vertex, std::size_t &num_edges,
+                                 bool &has_coordinates) {
+    std::ifstream file(path, std::ios::binary);
+    uint64_t vertexes, edges;
+    uint32_t flags;
+    if (!file.is_open() || !readHeader(file, vertexes, edges, flags)) {
+        return false;
+    }
+
+    num_vertex = (int) vertexes;
+    num_edges = edges;
+    has_coordinates = (flags & FLAG_COORDINATES) != 0;
+    return true;
+}
+
+bool generator::readBinary(const std::string &path, Instance &instance) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    auto file_size = (uint64_t) file.tellg();
+    file.seekg(0);
+
+    uint64_t num_vertex, num_edges;
+    uint32_t flags;
+    if (!readHeader(file, num_vertex, num_edges, flags)) {
+        return false;
+    }
+
+    bool coordinates = (flags & FLAG_COORDINATES) != 0;
+    uint64_t expected = HEADER_SIZE + (coordinates ? num_vertex * 2 * sizeof(double) : 0)
+                      + num_edges * (2 * sizeof(int) + sizeof(double));
+    if (file_size != expected) {
+        return false;
+    }
+
+    instance = Instance();
+    instance.num_vertex = (int) num_vertex;
+    if (coordinates) {
+        instance.longitudes.resize(num_vertex);
+        instance.latitudes.resize(num_vertex);
+    }
+    instance.origins.resize(num_edges);
+    instance.dests.resize(num_edges);
+    instance.weights.resize(num_edges);
+
+    auto readArray = [&](auto &values) {
+        file.read(reinterpret_cast<char *>(values.data()), (std::streamsize) (values.size() * sizeof(values[0])));
+    };
+    readArray(instance.longitudes);
+    readArray(instance.latitudes);
+    readArray(instance.origins);
+    readArray(instance.dests);
+    readArray(instance.weights);
+    if (!file) {
+        return false;
+    }
+
+    for (std::size_t e = 0; e < num_edges; e++) {
+        if (instance.origins[e] < 0 || instance.origins[e] >= instance.num_vertex
+            || instance.dests[e] < 0 || instance.dests[e] >= instance.num_vertex) {
+            return false;
+        }
+    }
+    return true;
+}
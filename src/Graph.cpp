@@ -1,9 +1,25 @@
 #include "Graph.h"
+#include "CompactGraph.h"
+#include "Hilbert.h"
+#include "Instrumentation.h"
+#include "Trace.h"
+#include "LocalSearch.h"
 #include "MutablePriorityQueue.h"
+#include "Reordering.h"
+#include "SimulatedAnnealing.h"
+#include "ThreadPool.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <future>
 #include <limits>
+#include <mutex>
 #include <queue>
+#include <thread>
 
 Graph::Graph(bool coordinateMode): _coordinate_mode(coordinateMode) {}
 
@@ -17,7 +33,14 @@ Vertex* Graph::findVertex(int id) const {
 }
 
 bool Graph::addVertex(int id) {
-    return vertexSet.insert(std::make_pair(id, new Vertex(id))).second;
+    // every vertex of a graph in coordinate mode is a LongLatVertex
+    if (this->_coordinate_mode || findVertex(id) != nullptr) {
+        return false;
+    }
+
+    vertexSet.insert(std::make_pair(id, new Vertex(id)));
+    resetLocalityGraph();
+    return true;
 }
 
 bool Graph::addVertex(int id, double longitude, double latitude) {
@@ -30,6 +53,7 @@ bool Graph::addVertex(int id, double longitude, double latitude) {
     }
 
     vertexSet.insert(std::make_pair(id, new LongLatVertex(id, longitude, latitude)));
+    resetLocalityGraph();
     return true;
 }
 
@@ -46,10 +70,21 @@ bool Graph::removeVertex(int id) {
     }
     
     vertexSet.erase(id);
-    delete v;
+    deleteVertex(v);
+    _heuristic_scale = -1;
+    resetLocalityGraph();
+    _incomming_built = false;
     return true;
 }
 
+void Graph::deleteVertex(Vertex* v) {
+    if (_coordinate_mode) {
+        delete static_cast<LongLatVertex*>(v);
+    } else {
+        delete v;
+    }
+}
+
 //? think we could remove this function since it's not that useful (used 3 times and 6 lines of code could do the same)
 double Graph::findWeightEdge(int source, int dest){
     auto v1 = findVertex(source);
@@ -57,12 +92,21 @@ double Graph::findWeightEdge(int source, int dest){
         //? could we just exit the program since this is not supposed to happen in any algorithm?
         return 0;
     }
-    for (auto adj : v1->getAdj()){
-        if (adj->getDest()->getId() == dest){
-            return adj->getWeight();
-        }
+    Edge* e = v1->getEdge(dest);
+    return e != nullptr ? e->getWeight() : 0;
+}
+
+double Graph::findDistance(Vertex* source, Vertex* dest) const {
+    Edge* e = source->getEdge(dest->getId());
+    if (e != nullptr) {
+        return e->getWeight();
     }
-    return 0;
+
+    if (_coordinate_mode) {
+        return static_cast<LongLatVertex*>(source)->haversine(static_cast<LongLatVertex*>(dest));
+    }
+
+    return std::numeric_limits<double>::infinity();
 }
 
 bool Graph::addEdge(int source, int dest, double weight) {
@@ -73,6 +117,9 @@ bool Graph::addEdge(int source, int dest, double weight) {
     }
 
     v1->addEdge(v2, weight);
+    _heuristic_scale = -1;
+    resetLocalityGraph();
+    _incomming_built = false;
     return true;
 }
 
@@ -83,20 +130,26 @@ bool Graph::addBidirectionalEdge(int source, int dest, double weight) {
         return false;
     }
 
-    auto e1 = v1->addEdge(v2, weight);
-    auto e2 = v2->addEdge(v1, weight);
-
-    e1->setReverse(e2);
-    e2->setReverse(e1);
+    // the twins find each other through Edge::getReverse, no pointer is stored
+    v1->addEdge(v2, weight);
+    v2->addEdge(v1, weight);
+    _heuristic_scale = -1;
+    resetLocalityGraph();
+    _incomming_built = false;
 
     return true;
 }
 
+void Graph::sortAdjacency() {
+    for (auto v: vertexSet) {
+        v.second->sortAdjacency();
+    }
+}
+
 void Graph::dijkstra(Vertex* source) {
-    auto cmp = [](Vertex* a, Vertex* b) {
-        return a->getDistance() < b->getDistance();
-    };
-    std::priority_queue<Vertex *, std::vector<Vertex *>, decltype(cmp)> pq(cmp);
+    TRACE_SPAN("dijkstra");
+    using Entry = std::pair<double, Vertex *>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> pq;
 
     for (auto v: vertexSet) {
         v.second->setVisited(false);
@@ -104,25 +157,201 @@ void Graph::dijkstra(Vertex* source) {
     }
 
     source->setDistance(0);
-    pq.push(source);
+    pq.push({0, source});
+    INSTRUMENT_COUNT(DIJKSTRA_PUSHES);
     while (!pq.empty()) {
-        Vertex* u = pq.top(); pq.pop();
+        Vertex* u = pq.top().second; pq.pop();
+        if (u->isVisited()) {
+            continue; // outdated entry, u was already settled with a smaller distance
+        }
         u->setVisited(true);
 
         for (Edge* e: u->getAdj()) {
             Vertex* v = e->getDest();
             double w = e->getWeight();
-            if (!v->isVisited() && u->getDistance() != std::numeric_limits<double>::max() && u->getDistance() + w < v->getDistance()) {
+            INSTRUMENT_COUNT(DIJKSTRA_RELAXATIONS);
+            if (!v->isVisited() && u->getDistance() + w < v->getDistance()) {
                 v->setDistance(u->getDistance() + w);
-                pq.push(v);
+                pq.push({v->getDistance(), v});
+                INSTRUMENT_COUNT(DIJKSTRA_PUSHES);
+            }
+        }
+    }
+}
+
+void Graph::deltaStepping(Vertex* source, double delta, unsigned int num_threads) {
+    const CompactGraph &compact = getLocalityGraph();
+    std::vector<int> index = {source->getId()};
+    mapTour(index, true);
+
+    ThreadPool pool(num_threads);
+    std::vector<double> dist = compact.deltaStepping(index[0], delta, pool);
+
+    for (int i = 0; i < compact.getNumVertex(); i++) {
+        Vertex* v = findVertex(compact.getOriginalId(i));
+        bool reachable = dist[i] != std::numeric_limits<double>::infinity();
+        v->setVisited(reachable);
+        v->setDistance(reachable ? dist[i] : std::numeric_limits<double>::max());
+    }
+}
+
+void Graph::buildIncomming() {
+    for (auto v: vertexSet) {
+        v.second->clearIncomming();
+    }
+    for (auto v: vertexSet) {
+        for (Edge* e: v.second->getAdj()) {
+            e->getDest()->addIncomming(e);
+        }
+    }
+    _incomming_built = true;
+}
+
+std::size_t Graph::idBound() const {
+    int max_id = -1;
+    for (auto v: vertexSet) {
+        max_id = std::max(max_id, v.first);
+    }
+    return max_id + 1;
+}
+
+double Graph::bidirectionalDijkstra(Vertex* source, Vertex* dest, unsigned int *settled) {
+    const double INF = std::numeric_limits<double>::infinity();
+    if (!_incomming_built) {
+        buildIncomming();
+    }
+    // indexed by id, which are not dense once a vertex was removed
+    std::size_t n = idBound();
+    unsigned int num_settled = 0;
+    if (source == dest) {
+        if (settled != nullptr) *settled = 0;
+        return 0;
+    }
+
+    // index 0 is the forward search, 1 the backward one
+    std::vector<double> dist[2] = {std::vector<double>(n, INF), std::vector<double>(n, INF)};
+    std::vector<bool> done[2] = {std::vector<bool>(n, false), std::vector<bool>(n, false)};
+    using Entry = std::pair<double, Vertex*>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> pq[2];
+
+    dist[0][source->getId()] = 0;
+    dist[1][dest->getId()] = 0;
+    pq[0].push({0, source});
+    pq[1].push({0, dest});
+
+    double best = INF;
+    while (!pq[0].empty() && !pq[1].empty()) {
+        // no path through an unsettled vertex can beat the best one found
+        if (pq[0].top().first + pq[1].top().first >= best) {
+            break;
+        }
+
+        int side = pq[0].top().first <= pq[1].top().first ? 0 : 1;
+        auto [d, u] = pq[side].top();
+        pq[side].pop();
+        if (done[side][u->getId()]) {
+            continue;
+        }
+        done[side][u->getId()] = true;
+        num_settled++;
+
+        for (Edge* e: side == 0 ? u->getAdj() : u->getIncomming()) {
+            Vertex* v = side == 0 ? e->getDest() : e->getOrigin();
+            double nd = d + e->getWeight();
+            if (nd < dist[side][v->getId()]) {
+                dist[side][v->getId()] = nd;
+                pq[side].push({nd, v});
+            }
+            // the other search already reached v, this is a candidate path
+            if (nd + dist[1 - side][v->getId()] < best) {
+                best = nd + dist[1 - side][v->getId()];
             }
         }
     }
+
+    if (settled != nullptr) {
+        *settled = num_settled;
+    }
+    return best;
+}
+
+double Graph::aStar(Vertex* source, Vertex* dest, unsigned int *settled) {
+    const double INF = std::numeric_limits<double>::infinity();
+    if (!_coordinate_mode) {
+        return INF;
+    }
+
+    if (_heuristic_scale < 0) {
+        _heuristic_scale = INF;
+        for (auto v: vertexSet) {
+            auto u = static_cast<LongLatVertex*>(v.second);
+            for (Edge* e: u->getAdj()) {
+                double straight = u->haversine(static_cast<LongLatVertex*>(e->getDest()));
+                if (straight > 0) {
+                    _heuristic_scale = std::min(_heuristic_scale, e->getWeight() / straight);
+                }
+            }
+        }
+        if (_heuristic_scale == INF) {
+            _heuristic_scale = 0;
+        }
+    }
+
+    std::size_t n = idBound(); // indexed by id, like bidirectionalDijkstra
+    auto target = static_cast<LongLatVertex*>(dest);
+    std::vector<double> dist(n, INF);
+    std::vector<bool> done(n, false);
+    unsigned int num_settled = 0;
+
+    using Entry = std::pair<double, Vertex*>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> pq;
+    dist[source->getId()] = 0;
+    pq.push({_heuristic_scale * static_cast<LongLatVertex*>(source)->haversine(target), source});
+
+    double result = INF;
+    while (!pq.empty()) {
+        Vertex* u = pq.top().second;
+        pq.pop();
+        if (done[u->getId()]) {
+            continue;
+        }
+        done[u->getId()] = true;
+        num_settled++;
+
+        if (u == dest) {
+            result = dist[u->getId()];
+            break;
+        }
+
+        for (Edge* e: u->getAdj()) {
+            Vertex* v = e->getDest();
+            double nd = dist[u->getId()] + e->getWeight();
+            if (nd < dist[v->getId()]) {
+                dist[v->getId()] = nd;
+                pq.push({nd + _heuristic_scale * static_cast<LongLatVertex*>(v)->haversine(target), v});
+            }
+        }
+    }
+
+    if (settled != nullptr) {
+        *settled = num_settled;
+    }
+    return result;
+}
+
+double Graph::shortestPathDistance(Vertex* source, Vertex* dest) {
+    return _coordinate_mode ? aStar(source, dest) : bidirectionalDijkstra(source, dest);
 }
 
 //! recursive function for tsp bruteforce (refactor later)
-void Graph::tspBacktrackBruteforce(Vertex* current, double current_cost, int num_visited, double& min_cost, std::vector<Vertex *> &tsp_path) {
+void Graph::tspBacktrackBruteforce(Vertex* current, double current_cost, int num_visited, double& min_cost,
+                                   std::vector<Vertex *> &tsp_path, SolveControl* control) {
+    if (control != nullptr && control->poll(1)) {
+        return;
+    }
+    INSTRUMENT_COUNT(BRUTEFORCE_NODES);
     if (num_visited == getNumVertex()) {
+        INSTRUMENT_COUNT(BRUTEFORCE_LEAVES);
         double cost = current_cost;
         bool hasEdge = false;
         for (Edge* e: current->getAdj()) {
@@ -134,13 +363,15 @@ void Graph::tspBacktrackBruteforce(Vertex* current, double current_cost, int num
         }
 
         if (!hasEdge) {
-            dijkstra(current);
-            cost += findVertex(0)->getDistance(); // use dijkstra to get the distance between current and 0
-            // for real world graph use latitude and longitude (maybe haversine algorithm)
+            // point to point query, a full dijkstra would also reset the visited flags of the backtracking
+            cost += shortestPathDistance(current, findVertex(0));
         }
 
         if (cost < min_cost) {
             min_cost = cost;
+            if (control != nullptr) {
+                control->reportCost(cost);
+            }
 
             Vertex* init = findVertex(0);
 
@@ -162,14 +393,15 @@ void Graph::tspBacktrackBruteforce(Vertex* current, double current_cost, int num
         if (!w->isVisited()) {
             w->setVisited(true);
             w->setPath(e);
-            tspBacktrackBruteforce(w, current_cost + e->getWeight(), num_visited + 1, min_cost, tsp_path);
+            tspBacktrackBruteforce(w, current_cost + e->getWeight(), num_visited + 1, min_cost, tsp_path, control);
             w->setVisited(false);
             w->setPath(nullptr);
         }
     }
 }
 
-double Graph::tspBruteforce(std::vector<Vertex *> &tsp_path) {
+double Graph::tspBruteforce(std::vector<Vertex *> &tsp_path, SolveControl* control) {
+    TRACE_SPAN("bruteforce");
     for (auto v: vertexSet) {
         v.second->setVisited(false);
         v.second->setPath(nullptr);
@@ -179,28 +411,51 @@ double Graph::tspBruteforce(std::vector<Vertex *> &tsp_path) {
 
     auto init = findVertex(0);
     init->setVisited(true);
-    tspBacktrackBruteforce(init, 0, 1, min_cost, tsp_path);
+    tspBacktrackBruteforce(init, 0, 1, min_cost, tsp_path, control);
 
-    return min_cost;
+    if (control != nullptr) {
+        control->flush();
+        control->setOptimal(!control->isStopped() && !tsp_path.empty());
+    }
+    // no tour (no cycle through every vertex, or stopped before the first one) costs infinity like in the other solvers
+    return tsp_path.empty() ? std::numeric_limits<double>::infinity() : min_cost;
 }
 
 int Graph::getNumVertex() const {
     return this->vertexSet.size();
 }
 
+bool Graph::isCoordinateMode() const {
+    return this->_coordinate_mode;
+}
+
+void Graph::setDenseMatrixLimit(std::size_t bytes) {
+    this->_dense_matrix_limit = bytes;
+}
+
+std::size_t Graph::getDenseMatrixLimit() const {
+    return this->_dense_matrix_limit;
+}
+
+bool Graph::fitsDenseMatrix() const {
+    std::size_t n = getNumVertex();
+    return n * n * sizeof(double) <= this->_dense_matrix_limit;
+}
+
 std::unordered_map<int, Vertex *> Graph::getVertexSet() const {
     return this->vertexSet;
 }
 
 void Graph::prim(Vertex* source, std::vector<Vertex*> &result, double &cost) {
+    TRACE_SPAN("prim");
     Graph* mst = new Graph(_coordinate_mode);
     MutablePriorityQueue<Vertex> pq;
     for (auto v: vertexSet) {
-        LongLatVertex* llv = dynamic_cast<LongLatVertex*>(v.second);
-        if (llv == nullptr) {
-            mst->addVertex(v.second->getId());
-        } else {
+        if (_coordinate_mode) {
+            auto llv = static_cast<LongLatVertex*>(v.second);
             mst->addVertex(llv->getId(), llv->getLong(), llv->getLat());
+        } else {
+            mst->addVertex(v.second->getId());
         }
         v.second->setVisited(false);
         v.second->setDistance(std::numeric_limits<double>::max());
@@ -238,6 +493,7 @@ void Graph::prim(Vertex* source, std::vector<Vertex*> &result, double &cost) {
     }
     Vertex* v = mst->findVertex(0);
     Vertex* prev = nullptr;
+    TRACE_SPAN("preorder");
     preorderMST(v, result, cost, prev);
     delete mst;
 }
@@ -255,11 +511,8 @@ void Graph::preorderMST(Vertex* current, std::vector<Vertex*> &result, double &c
         else if (!e->getDest()->isVisited()) {
             double tmp = findWeightEdge(prev->getId(), e->getDest()->getId());
             if (tmp == 0) {
-                LongLatVertex* orig = dynamic_cast<LongLatVertex*>(prev);
-                LongLatVertex* dest = dynamic_cast<LongLatVertex*>(e->getDest());
-                if (orig != nullptr && dest != nullptr) {
-                    double tmp = orig->haversine(dest);
-                    cost += tmp;
+                if (_coordinate_mode) {
+                    cost += static_cast<LongLatVertex*>(prev)->haversine(static_cast<LongLatVertex*>(e->getDest()));
                 }
             } else {
                 cost += tmp;
@@ -285,7 +538,7 @@ double Graph::triangularApproximation(std::vector<Vertex *> &tsp_path) {
     return cost;
 }
 
-double Graph::tspNearestNeighbor(std::vector<Vertex*>& tsp_path, unsigned int two_opt_iterations) {
+double Graph::tspNearestNeighbor(std::vector<Vertex*>& tsp_path, unsigned int two_opt_iterations, SolveControl* control) {
     tsp_path.clear();
     std::size_t num_vertices = vertexSet.size();
     std::vector<bool> visited(num_vertices, false);
@@ -295,6 +548,7 @@ double Graph::tspNearestNeighbor(std::vector<Vertex*>& tsp_path, unsigned int tw
     tsp_path.push_back(current);
     visited[start_idx] = true;
 
+    TRACE_SPAN("nearest-neighbor");
     while (tsp_path.size() < num_vertices) {
         double min_edge_weight = std::numeric_limits<double>::infinity();
         Vertex* next_vertex = nullptr;
@@ -320,7 +574,7 @@ double Graph::tspNearestNeighbor(std::vector<Vertex*>& tsp_path, unsigned int tw
         Edge* final_edge = tsp_path.back()->getEdge(vertexSet[start_idx]->getId());
         tsp_path.push_back(vertexSet[start_idx]);
     }
-    twoOptAlgorithm(tsp_path, two_opt_iterations);
+    twoOptAlgorithm(tsp_path, two_opt_iterations, control);
 
     double cost = 0;
     for (int i = 0; i < tsp_path.size() - 1; i++) {
@@ -341,15 +595,34 @@ void perform2OptSwap(std::vector<Vertex*>& tsp_path, int i, int k) {
 }
 
 // 2-opt algorithm
-void Graph::twoOptAlgorithm(std::vector<Vertex*>& tsp_path, unsigned int two_opt_iterations) {
+void Graph::twoOptAlgorithm(std::vector<Vertex*>& tsp_path, unsigned int two_opt_iterations, SolveControl* control) {
+    TRACE_SPAN("two-opt");
     int n = tsp_path.size();
     unsigned int iterations = 0;
     bool improvement = true;
 
+    // only followed for the progress of the control
+    double cost = 0;
+    if (control != nullptr) {
+        for (int i = 0; i + 1 < n; i++) {
+            Edge* e = tsp_path[i]->getEdge(tsp_path[i + 1]->getId());
+            cost += e == nullptr ? std::numeric_limits<double>::infinity() : e->getWeight();
+        }
+        control->reportCost(cost);
+    }
+
     while (improvement && iterations < two_opt_iterations) {
         iterations++;
+        TRACE_SPAN("two-opt-pass", iterations);
         improvement = false;
         for (int i = 0; i < n - 2; ++i) {
+            if (control != nullptr) {
+                control->reportCost(cost);
+                control->addWork(n - i - 2);
+                if (control->shouldStop()) {
+                    return; // every swap kept the path valid
+                }
+            }
             for (int k = i + 2; k < n; ++k) {
                 auto a = tsp_path[i]->getEdge(tsp_path[i + 1]->getId());
                 auto b = tsp_path[k]->getEdge(tsp_path[(k + 1) % n]->getId());
@@ -358,13 +631,898 @@ void Graph::twoOptAlgorithm(std::vector<Vertex*>& tsp_path, unsigned int two_opt
                 if (a == nullptr || b == nullptr || c == nullptr || d == nullptr) {
                     continue;
                 }
+                INSTRUMENT_COUNT(TWO_OPT_EVALUATED);
                 double currentDistance = a->getWeight() + b->getWeight();
                 double newDistance = c->getWeight() + d->getWeight();
                 if (newDistance < currentDistance) {
+                    INSTRUMENT_COUNT(TWO_OPT_APPLIED);
                     perform2OptSwap(tsp_path, i + 1, k);
+                    cost += newDistance - currentDistance;
                     improvement = true;
                 }
             }
         }
     }
 }
+
+double Graph::tspHilbertCurve(std::vector<Vertex *> &tsp_path, bool two_opt, SolveControl* control) {
+    tsp_path.clear();
+    if (!_coordinate_mode || vertexSet.empty()) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    std::vector<Vertex *> vertexes;
+    std::vector<double> longitudes, latitudes;
+    vertexes.reserve(vertexSet.size());
+    longitudes.reserve(vertexSet.size());
+    latitudes.reserve(vertexSet.size());
+
+    for (auto v: vertexSet) {
+        auto llv = static_cast<LongLatVertex*>(v.second);
+        vertexes.push_back(llv);
+        longitudes.push_back(llv->getLong());
+        latitudes.push_back(llv->getLat());
+    }
+
+    std::vector<uint32_t> keys = hilbert::indexes(longitudes, latitudes);
+    std::vector<int> order(vertexes.size());
+    for (std::size_t i = 0; i < order.size(); i++) {
+        order[i] = (int) i;
+    }
+    hilbert::radixSort(keys, order);
+
+    std::vector<int> tour;
+    tour.reserve(order.size());
+    for (int i: order) {
+        tour.push_back(vertexes[i]->getId());
+    }
+
+    if (!two_opt) {
+        // tourToPath rotates the tour so it starts (and ends) at vertex 0 like the other algorithms
+        tourToPath(tour, tsp_path);
+        double cost = 0;
+        for (std::size_t i = 0; i + 1 < tsp_path.size(); i++) {
+            cost += findDistance(tsp_path[i], tsp_path[i + 1]);
+        }
+        return cost;
+    }
+
+    // the 2-opt moves need every pair of vertexes, not only the edges, or sparse graphs are never improved
+    mapTour(tour, true);
+    double cost;
+    if (!fitsDenseMatrix()) {
+        TiledDistanceMatrix dist;
+        if (!openTiledMatrix(dist)) {
+            return std::numeric_limits<double>::infinity();
+        }
+        cost = twoOptTour(dist, tour, control);
+    } else {
+        DistanceMatrix dist(getLocalityGraph());
+        cost = twoOptTour(dist, tour, control);
+    }
+
+    mapTour(tour, false);
+    tourToPath(tour, tsp_path);
+    return cost;
+}
+
+template<class Matrix>
+double Graph::twoOptTour(const Matrix &dist, std::vector<int> &tour, SolveControl* control) const {
+    // number of candidate neighbors per vertex in the 2-opt moves
+    const unsigned int num_neighbors = 10;
+
+    auto neighbors = localsearch::nearestNeighbors(dist, num_neighbors);
+    if (control != nullptr) {
+        control->reportCost(dist.tourCost(tour));
+    }
+    {
+        TRACE_SPAN("two-opt");
+        localsearch::twoOpt(tour, dist, neighbors, {}, control);
+    }
+    if (control != nullptr) {
+        control->flush();
+    }
+    return dist.tourCost(tour);
+}
+
+void Graph::tourToPath(const std::vector<int> &tour, std::vector<Vertex *> &tsp_path) const {
+    tsp_path.clear();
+    if (tour.empty()) {
+        return;
+    }
+
+    std::size_t start = 0;
+    while (start < tour.size() && tour[start] != 0) {
+        start++;
+    }
+    start %= tour.size();
+
+    tsp_path.reserve(tour.size() + 1);
+    for (std::size_t i = 0; i < tour.size(); i++) {
+        tsp_path.push_back(findVertex(tour[(start + i) % tour.size()]));
+    }
+    tsp_path.push_back(tsp_path.front());
+}
+
+const CompactGraph& Graph::getLocalityGraph() const {
+    std::call_once(*_locality_once, [this]() {
+        CompactGraph compact(*this);
+        _locality_graph = std::make_unique<CompactGraph>(compact.permute(reordering::localityOrder(compact)));
+    });
+    return *_locality_graph;
+}
+
+void Graph::resetLocalityGraph() {
+    // an unused flag can stay, so loading the edges allocates nothing here
+    if (_locality_graph != nullptr) {
+        _locality_graph.reset();
+        _locality_once = std::make_unique<std::once_flag>();
+    }
+}
+
+void Graph::mapTour(std::vector<int> &tour, bool to_index) const {
+    const CompactGraph &graph = getLocalityGraph();
+    std::vector<int> ids(graph.getNumVertex());
+    for (int i = 0; i < graph.getNumVertex(); i++) {
+        ids[i] = graph.getOriginalId(i);
+    }
+    std::vector<int> map = to_index ? reordering::inverse(ids) : ids;
+
+    for (int &v: tour) {
+        v = map[v];
+    }
+}
+
+// Best known insertion of a vertex not yet in the tour
+// Cheapest insertion positions of a vertex, sorted by cost. Every edge of the tour that is not listed costs at least
+// bound, so the whole tour only has to be scanned again once every listed edge was split
+struct InsertionPositions {
+    static const int CAPACITY = 8;
+
+    struct Position {
+        double cost;
+        int from;
+        int to;
+    };
+
+    Position positions[CAPACITY];
+    int size = 0;
+    double bound = std::numeric_limits<double>::infinity();
+
+    // Keep an edge if it is one of the cheapest seen, ties go after the positions already listed
+    void offer(double cost, int from, int to) {
+        if (cost >= bound) {
+            return;
+        }
+        int i = size;
+        if (size == CAPACITY) {
+            bound = positions[CAPACITY - 1].cost;
+            i--;
+        } else {
+            size++;
+        }
+        for (; i > 0 && positions[i - 1].cost > cost; i--) {
+            positions[i] = positions[i - 1];
+        }
+        positions[i] = {cost, from, to};
+    }
+
+    // Drop the cheapest position
+    void popFront() {
+        std::copy(positions + 1, positions + size, positions);
+        size--;
+    }
+};
+
+struct InsertionCandidate {
+    int vertex;
+    double key; // insertion cost (cheapest) or distance to the tour (farthest)
+    int from;   // best insertion is between from and to
+    int to;
+    int queueIndex = 0;
+    InsertionPositions cheapest; // only used by cheapest insertion, positions[0] is always (from, to)
+};
+
+double Graph::insertionHeuristic(std::vector<Vertex *> &tsp_path, bool farthest) {
+    TRACE_SPAN(farthest ? "farthest-insertion" : "cheapest-insertion");
+    tsp_path.clear();
+    int n = getNumVertex();
+    if (n == 0) {
+        return 0;
+    }
+
+    DistanceMatrix dist(*this);
+
+    // the tour is kept as a circular linked list, starting as a loop on vertex 0
+    std::vector<int> next(n, -1);
+    next[0] = 0;
+
+    // an insertion through a missing edge is infeasible whatever edge it replaces (inf - inf would be NaN), and the
+    // loop on vertex 0 has no edge to replace (the matrix diagonal is infinite)
+    auto insertion_cost = [&](int v, int a, int b) {
+        double added = dist(a, v) + dist(v, b);
+        return added == std::numeric_limits<double>::infinity() || a == b ? added : added - dist(a, b);
+    };
+
+    // cheapest position of v in the current tour
+    auto best_position = [&](InsertionCandidate &c) {
+        double best = std::numeric_limits<double>::infinity();
+        int a = 0;
+        do {
+            double cost = insertion_cost(c.vertex, a, next[a]);
+            if (cost < best || c.from == -1) {
+                best = cost;
+                c.from = a;
+                c.to = next[a];
+            }
+            a = next[a];
+        } while (a != 0);
+        return best;
+    };
+
+    // list the cheapest positions of v in the current tour again
+    auto scan_positions = [&](InsertionCandidate &c) {
+        c.cheapest = InsertionPositions();
+        int a = 0;
+        do {
+            c.cheapest.offer(insertion_cost(c.vertex, a, next[a]), a, next[a]);
+            a = next[a];
+        } while (a != 0);
+    };
+
+    std::vector<InsertionCandidate> candidates(n);
+    auto cmp = [farthest](InsertionCandidate* a, InsertionCandidate* b) {
+        return farthest ? a->key > b->key : a->key < b->key;
+    };
+    MutablePriorityQueue<InsertionCandidate, decltype(cmp)> pq(cmp);
+
+    for (int v = 1; v < n; v++) {
+        candidates[v] = {v, 0, 0, 0, 0, {}};
+        candidates[v].key = farthest ? dist(0, v) : insertion_cost(v, 0, 0);
+        candidates[v].cheapest.offer(candidates[v].key, 0, 0);
+        pq.insert(&candidates[v]);
+    }
+
+    while (!pq.empty()) {
+        InsertionCandidate* c = pq.extractMin();
+        int u = c->vertex;
+        if (farthest) {
+            c->from = -1;
+            best_position(*c);
+        }
+
+        int a = c->from, b = c->to;
+        next[a] = u;
+        next[u] = b;
+
+        for (InsertionCandidate* w = candidates.data() + 1; w != candidates.data() + n; w++) {
+            if (w->queueIndex == 0) {
+                continue;
+            }
+
+            if (farthest) {
+                if (dist(u, w->vertex) < w->key) {
+                    w->key = dist(u, w->vertex);
+                    pq.increaseKey(w); // farther vertexes are at the top, a closer one goes down
+                }
+            } else {
+                InsertionPositions &positions = w->cheapest;
+                positions.offer(insertion_cost(w->vertex, a, u), a, u);
+                positions.offer(insertion_cost(w->vertex, u, b), u, b);
+                bool split = w->from == a && w->to == b;
+                // listed edges split by earlier insertions are only dropped once they reach the front
+                while (positions.size > 0 && next[positions.positions[0].from] != positions.positions[0].to) {
+                    positions.popFront();
+                }
+                if (positions.size == 0) {
+                    scan_positions(*w);
+                }
+
+                const InsertionPositions::Position &best = positions.positions[0];
+                if (split || best.cost < w->key) {
+                    w->key = best.cost;
+                    w->from = best.from;
+                    w->to = best.to;
+                    if (split) {
+                        pq.updateKey(w);
+                    } else {
+                        pq.decreaseKey(w);
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<int> tour;
+    tour.reserve(n);
+    int v = 0;
+    do {
+        tour.push_back(v);
+        v = next[v];
+    } while (v != 0);
+
+    tourToPath(tour, tsp_path);
+    return dist.tourCost(tour);
+}
+
+double Graph::tspCheapestInsertion(std::vector<Vertex *> &tsp_path) {
+    return insertionHeuristic(tsp_path, false);
+}
+
+double Graph::tspFarthestInsertion(std::vector<Vertex *> &tsp_path) {
+    return insertionHeuristic(tsp_path, true);
+}
+
+bool Graph::openTiledMatrix(TiledDistanceMatrix &dist) const {
+    TRACE_SPAN("tiled-matrix");
+    static std::atomic<unsigned int> next_file{0};
+    std::error_code error;
+    std::filesystem::path dir = std::filesystem::temp_directory_path(error);
+    if (error) {
+        return false;
+    }
+    std::string path = (dir / ("feup_da2_" + std::to_string(reinterpret_cast<std::uintptr_t>(this)) + "_"
+                               + std::to_string(next_file++) + ".tiles")).string();
+
+    bool opened = TiledDistanceMatrix::create(path, getLocalityGraph()) && dist.open(path);
+    std::filesystem::remove(path, error);
+    return opened;
+}
+
+double Graph::tspIteratedLocalSearch(std::vector<Vertex *> &tsp_path, double time_limit, unsigned int num_threads,
+                                     SolveControl* control) {
+    tsp_path.clear();
+    if (getNumVertex() == 0) {
+        return 0;
+    }
+
+    // tours use the indexes of the locality graph, so vertexes close together have close matrix columns
+    if (!fitsDenseMatrix()) {
+        TiledDistanceMatrix dist;
+        if (!openTiledMatrix(dist)) {
+            return std::numeric_limits<double>::infinity();
+        }
+        return iteratedLocalSearch(dist, tsp_path, time_limit, num_threads, control);
+    }
+    DistanceMatrix dist(getLocalityGraph());
+    return iteratedLocalSearch(dist, tsp_path, time_limit, num_threads, control);
+}
+
+template<class Matrix>
+double Graph::iteratedLocalSearch(const Matrix &dist, std::vector<Vertex *> &tsp_path, double time_limit,
+                                  unsigned int num_threads, SolveControl* control) {
+    // number of candidate neighbors per vertex in the 2-opt moves
+    const unsigned int num_neighbors = 10;
+
+    int n = getNumVertex();
+    if (control != nullptr) {
+        time_limit = control->getRemaining(time_limit);
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto deadline = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(time_limit));
+    auto exchange_period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(std::max(0.01, time_limit / 20)));
+
+    TRACE_SPAN("iterated-local-search");
+    auto neighbors = localsearch::nearestNeighbors(dist, num_neighbors);
+
+    // the seed is built on the matrix, so it visits every vertex even where the graph has no edge to continue
+    std::vector<int> best_tour = {0};
+    mapTour(best_tour, true);
+    best_tour = localsearch::nearestNeighborTour(dist, best_tour.front());
+    localsearch::twoOpt(best_tour, dist, neighbors, {}, control);
+    double best_cost = dist.tourCost(best_tour);
+    if (control != nullptr) {
+        control->flush();
+        control->reportCost(best_cost);
+    }
+    if (n < 8) {
+        // too small for a double bridge kick
+        mapTour(best_tour, false);
+        tourToPath(best_tour, tsp_path);
+        return best_cost;
+    }
+
+    std::mutex best_mutex;
+
+    auto search = [&](unsigned int t) {
+        TRACE_SPAN("local-search-worker", t);
+        localsearch::Random rng(0x9E3779B97F4A7C15ull * (t + 1));
+        std::vector<int> current, candidate, endpoints;
+        double current_cost;
+        {
+            std::lock_guard<std::mutex> lock(best_mutex);
+            current = best_tour;
+            current_cost = best_cost;
+        }
+
+        auto next_exchange = clock::now() + exchange_period;
+        while ((control == nullptr || !control->shouldStop()) && clock::now() < deadline) {
+            candidate = current;
+            double cost = current_cost + localsearch::doubleBridge(candidate, dist, rng, endpoints);
+            cost += localsearch::twoOpt(candidate, dist, neighbors, endpoints, control);
+            if (cost < current_cost - 1e-9) {
+                current.swap(candidate);
+                current_cost = cost;
+                if (control != nullptr) {
+                    control->reportCost(cost);
+                }
+            }
+            if (control != nullptr) {
+                control->poll(1); // counts the kick, the loop condition reads the clock
+            }
+
+            if (clock::now() >= next_exchange) {
+                std::lock_guard<std::mutex> lock(best_mutex);
+                if (current_cost < best_cost) {
+                    best_tour = current;
+                    best_cost = current_cost;
+                } else if (best_cost < current_cost) {
+                    current = best_tour;
+                    current_cost = best_cost;
+                }
+                next_exchange += exchange_period;
+            }
+        }
+
+        if (control != nullptr) {
+            control->flush();
+        }
+        std::lock_guard<std::mutex> lock(best_mutex);
+        if (current_cost < best_cost) {
+            best_tour = current;
+            best_cost = current_cost;
+        }
+    };
+
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::vector<std::thread> threads;
+    for (unsigned int t = 1; t < num_threads; t++) {
+        threads.emplace_back(search, t);
+    }
+    search(0);
+    for (auto &thread: threads) {
+        thread.join();
+    }
+
+    // recalculated so accumulated floating point error does not leak into the result
+    best_cost = dist.tourCost(best_tour);
+    mapTour(best_tour, false);
+    tourToPath(best_tour, tsp_path);
+    return best_cost;
+}
+
+double Graph::tspSimulatedAnnealing(std::vector<Vertex *> &tsp_path, double time_limit, unsigned int num_threads,
+                                    double &moves_per_second, SolveControl* control) {
+    moves_per_second = 0;
+    tsp_path.clear();
+    if (getNumVertex() == 0) {
+        return 0;
+    }
+
+    if (!fitsDenseMatrix()) {
+        TiledDistanceMatrix dist;
+        if (!openTiledMatrix(dist)) {
+            return std::numeric_limits<double>::infinity();
+        }
+        return simulatedAnnealing(dist, tsp_path, time_limit, num_threads, moves_per_second, control);
+    }
+    DistanceMatrix dist(getLocalityGraph());
+    return simulatedAnnealing(dist, tsp_path, time_limit, num_threads, moves_per_second, control);
+}
+
+template<class Matrix>
+double Graph::simulatedAnnealing(const Matrix &dist, std::vector<Vertex *> &tsp_path, double time_limit,
+                                 unsigned int num_threads, double &moves_per_second, SolveControl* control) {
+    // the seed is built on the matrix, so it visits every vertex even where the graph has no edge to continue
+    std::vector<int> tour = {0};
+    mapTour(tour, true);
+    tour = localsearch::nearestNeighborTour(dist, tour.front());
+
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    BasicSimulatedAnnealing<Matrix> annealing(dist);
+    double cost = annealing.run(tour, time_limit, num_threads, control);
+    moves_per_second = annealing.getMovesPerSecond();
+
+    mapTour(tour, false);
+    tourToPath(tour, tsp_path);
+    return cost;
+}
+
+std::vector<int> Graph::partitionByCoordinates(unsigned int k, std::vector<int> &cluster_order) const {
+    // iterations of Lloyd's algorithm and centroids each vertex is compared with
+    const unsigned int max_iterations = 10;
+    const unsigned int num_candidates = 8;
+
+    int n = getNumVertex();
+    std::vector<double> xs(n), ys(n);
+    double mean_lat = 0;
+    for (auto v: vertexSet) {
+        auto llv = static_cast<LongLatVertex*>(v.second);
+        xs[v.first] = llv->getLong();
+        ys[v.first] = llv->getLat();
+        mean_lat += llv->getLat();
+    }
+
+    // longitude degrees shrink away from the equator
+    double x_scale = std::cos(mean_lat / n * M_PI / 180.0);
+    for (double &x: xs) {
+        x *= x_scale;
+    }
+
+    std::vector<uint32_t> keys = hilbert::indexes(xs, ys);
+    std::vector<int> order(n);
+    for (int i = 0; i < n; i++) {
+        order[i] = i;
+    }
+    hilbert::radixSort(keys, order);
+
+    std::vector<int> labels(n);
+    for (int i = 0; i < n; i++) {
+        labels[order[i]] = (int) ((long long) i * k / n);
+    }
+
+    std::vector<double> cx(k), cy(k);
+    std::vector<int> count(k);
+    auto update_centroids = [&]() {
+        std::vector<double> sx(k, 0), sy(k, 0);
+        std::fill(count.begin(), count.end(), 0);
+        for (int i = 0; i < n; i++) {
+            sx[labels[i]] += xs[i];
+            sy[labels[i]] += ys[i];
+            count[labels[i]]++;
+        }
+        for (unsigned int c = 0; c < k; c++) {
+            if (count[c] > 0) {
+                cx[c] = sx[c] / count[c];
+                cy[c] = sy[c] / count[c];
+            }
+        }
+    };
+    update_centroids();
+
+    auto centroid_dist = [&](int a, int b) {
+        return (cx[a] - cx[b]) * (cx[a] - cx[b]) + (cy[a] - cy[b]) * (cy[a] - cy[b]);
+    };
+
+    std::vector<std::vector<int>> candidates(k);
+    std::vector<int> others(k);
+    for (unsigned int iteration = 0; iteration < max_iterations; iteration++) {
+        unsigned int m = std::min(num_candidates, k - 1);
+        for (unsigned int c = 0; c < k; c++) {
+            for (unsigned int o = 0; o < k; o++) {
+                others[o] = o;
+            }
+            std::swap(others[c], others[k - 1]);
+            std::partial_sort(others.begin(), others.begin() + m, others.end() - 1, [&](int a, int b) {
+                return centroid_dist(c, a) < centroid_dist(c, b);
+            });
+            candidates[c].assign(others.begin(), others.begin() + m);
+            candidates[c].push_back(c);
+        }
+
+        int changed = 0;
+        for (int i = 0; i < n; i++) {
+            int best = labels[i];
+            double best_dist = std::numeric_limits<double>::max();
+            for (int c: candidates[labels[i]]) {
+                double d = (xs[i] - cx[c]) * (xs[i] - cx[c]) + (ys[i] - cy[c]) * (ys[i] - cy[c]);
+                if (d < best_dist) {
+                    best_dist = d;
+                    best = c;
+                }
+            }
+            if (best != labels[i]) {
+                labels[i] = best;
+                changed++;
+            }
+        }
+
+        if (changed == 0) {
+            break;
+        }
+        update_centroids();
+    }
+
+    // visit the clusters in the Hilbert order of their centroids
+    std::vector<uint32_t> centroid_keys = hilbert::indexes(cx, cy);
+    cluster_order.resize(k);
+    for (unsigned int c = 0; c < k; c++) {
+        cluster_order[c] = c;
+    }
+    hilbert::radixSort(centroid_keys, cluster_order);
+
+    return labels;
+}
+
+std::vector<int> Graph::partitionByGraph(unsigned int k, std::vector<int> &cluster_order) const {
+    int n = getNumVertex();
+
+    // seeds spread over the ids by a fixed shuffle
+    std::vector<int> seeds(n);
+    for (int i = 0; i < n; i++) {
+        seeds[i] = i;
+    }
+    localsearch::Random rng(n);
+    for (int i = 0; i < (int) k; i++) {
+        std::swap(seeds[i], seeds[i + rng.below(n - i)]);
+    }
+    seeds.resize(k);
+
+    std::vector<int> labels(n, -1);
+    std::vector<double> dist(n, std::numeric_limits<double>::max());
+    using Entry = std::pair<double, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> pq;
+    for (unsigned int c = 0; c < k; c++) {
+        dist[seeds[c]] = 0;
+        labels[seeds[c]] = c;
+        pq.push({0, seeds[c]});
+    }
+
+    while (!pq.empty()) {
+        auto [d, u] = pq.top();
+        pq.pop();
+        if (d > dist[u]) {
+            continue;
+        }
+        for (Edge* e: findVertex(u)->getAdj()) {
+            int v = e->getDest()->getId();
+            if (d + e->getWeight() < dist[v]) {
+                dist[v] = d + e->getWeight();
+                labels[v] = labels[u];
+                pq.push({dist[v], v});
+            }
+        }
+    }
+
+    // vertexes unreachable from every seed are spread over the clusters
+    for (int i = 0; i < n; i++) {
+        if (labels[i] == -1) {
+            labels[i] = i % k;
+        }
+    }
+
+    // visit the clusters in the order of a tour over their seeds, by shortest path since seeds are rarely adjacent
+    // (one Dijkstra per seed, stopped once every seed is settled)
+    std::vector<int> seed_index(n, -1);
+    for (unsigned int c = 0; c < k; c++) {
+        seed_index[seeds[c]] = c;
+    }
+    DistanceMatrix seed_dist(k);
+    for (unsigned int a = 0; a < k; a++) {
+        std::fill(dist.begin(), dist.end(), std::numeric_limits<double>::max());
+        pq = decltype(pq)();
+        dist[seeds[a]] = 0;
+        pq.push({0, seeds[a]});
+        unsigned int settled = 0;
+        while (!pq.empty() && settled < k) {
+            auto [d, u] = pq.top();
+            pq.pop();
+            if (d > dist[u]) {
+                continue;
+            }
+            if (seed_index[u] != -1) {
+                settled++;
+                if (seed_index[u] != (int) a) {
+                    seed_dist.set(a, seed_index[u], d);
+                }
+            }
+            for (Edge* e: findVertex(u)->getAdj()) {
+                int v = e->getDest()->getId();
+                if (d + e->getWeight() < dist[v]) {
+                    dist[v] = d + e->getWeight();
+                    pq.push({dist[v], v});
+                }
+            }
+        }
+    }
+    cluster_order = localsearch::nearestNeighborTour(seed_dist, 0);
+    localsearch::twoOpt(cluster_order, seed_dist, localsearch::nearestNeighbors(seed_dist, 10));
+
+    return labels;
+}
+
+void Graph::optimizeTourWindow(std::vector<int> &tour, int position, int window) const {
+    int n = tour.size();
+    // a window over the whole tour is the cycle itself, including the edge that wraps around
+    bool whole = window >= n;
+    window = std::min(window, n);
+    int first = ((position - window / 2) % n + n) % n;
+    int size = whole ? window : window + 1;
+
+    std::vector<int> positions(window), local_tour(size);
+    for (int i = 0; i < window; i++) {
+        positions[i] = (first + i) % n;
+    }
+
+    DistanceMatrix dist(size);
+    for (int a = 0; a < window; a++) {
+        for (int b = 0; b < window; b++) {
+            if (a != b) {
+                dist.set(a, b, findDistance(findVertex(tour[positions[a]]), findVertex(tour[positions[b]])));
+            }
+        }
+        local_tour[a] = a;
+    }
+
+    if (whole) {
+        localsearch::twoOpt(local_tour, dist, localsearch::nearestNeighbors(dist, 10));
+    } else {
+        // the window is a path with fixed ends, closed into a cycle through a dummy vertex only adjacent to both ends
+        int dummy = window;
+        local_tour[window] = dummy;
+        dist.set(dummy, 0, 0); dist.set(0, dummy, 0);
+        dist.set(dummy, window - 1, 0); dist.set(window - 1, dummy, 0);
+
+        localsearch::twoOpt(local_tour, dist, localsearch::nearestNeighbors(dist, 10));
+
+        // open the cycle at the dummy vertex, keeping the original direction
+        std::rotate(local_tour.begin(), std::find(local_tour.begin(), local_tour.end(), dummy) + 1, local_tour.end());
+        local_tour.pop_back();
+        if (local_tour.front() != 0) {
+            std::reverse(local_tour.begin(), local_tour.end());
+        }
+    }
+
+    std::vector<int> vertexes(window);
+    for (int i = 0; i < window; i++) {
+        vertexes[i] = tour[positions[local_tour[i]]];
+    }
+    for (int i = 0; i < window; i++) {
+        tour[positions[i]] = vertexes[i];
+    }
+}
+
+double Graph::tspClusterDecomposition(std::vector<Vertex *> &tsp_path, unsigned int cluster_size, unsigned int num_threads,
+                                      SolveControl* control) {
+    // 2-opt candidates per vertex and vertexes re-optimized around each junction between clusters
+    const unsigned int num_neighbors = 10;
+    const int junction_window = 100;
+
+    tsp_path.clear();
+    int n = getNumVertex();
+    if (n == 0) {
+        return 0;
+    }
+
+    unsigned int k = std::max(1u, (unsigned int) ((n + std::max(1u, cluster_size) - 1) / std::max(1u, cluster_size)));
+    std::vector<int> cluster_order;
+    std::vector<int> labels = _coordinate_mode ? partitionByCoordinates(k, cluster_order) : partitionByGraph(k, cluster_order);
+
+    std::vector<std::vector<int>> members(k);
+    std::vector<int> local_index(n);
+    for (int v = 0; v < n; v++) {
+        local_index[v] = members[labels[v]].size();
+        members[labels[v]].push_back(v);
+    }
+
+    // route every cluster on its own, only its own distances are ever stored
+    auto solve_cluster = [&](unsigned int c) {
+        TRACE_SPAN("cluster", c);
+        const std::vector<int> &cluster = members[c];
+        int m = cluster.size();
+        DistanceMatrix dist(m);
+        for (int a = 0; a < m; a++) {
+            for (Edge* e: findVertex(cluster[a])->getAdj()) {
+                int dest = e->getDest()->getId();
+                if (labels[dest] == (int) c) {
+                    dist.set(a, local_index[dest], e->getWeight());
+                }
+            }
+        }
+        if (_coordinate_mode) {
+            for (int a = 0; a < m; a++) {
+                auto u = static_cast<LongLatVertex*>(findVertex(cluster[a]));
+                for (int b = a + 1; b < m; b++) {
+                    if (dist(a, b) == std::numeric_limits<double>::infinity()) {
+                        double d = u->haversine(static_cast<LongLatVertex*>(findVertex(cluster[b])));
+                        dist.set(a, b, d);
+                        dist.set(b, a, d);
+                    }
+                }
+            }
+        }
+
+        std::vector<int> tour = localsearch::nearestNeighborTour(dist, 0);
+        if (control == nullptr || !control->shouldStop()) {
+            localsearch::twoOpt(tour, dist, localsearch::nearestNeighbors(dist, num_neighbors), {}, control);
+        }
+        for (int &v: tour) {
+            v = cluster[v];
+        }
+        if (control != nullptr) {
+            control->flush();
+            control->addWork(1);
+        }
+        return tour;
+    };
+
+    std::vector<std::vector<int>> cluster_tours(k);
+    {
+        ThreadPool pool(num_threads);
+        std::vector<std::future<std::vector<int>>> results(k);
+        for (unsigned int c = 0; c < k; c++) {
+            if (!members[c].empty()) {
+                results[c] = pool.submit([&solve_cluster, c]() { return solve_cluster(c); });
+            }
+        }
+        for (unsigned int c = 0; c < k; c++) {
+            if (results[c].valid()) {
+                cluster_tours[c] = results[c].get();
+            }
+        }
+    }
+
+    // chain the cluster tours, opening each one at the edge that makes the connection cheapest
+    std::vector<int> tour;
+    std::vector<int> junctions;
+    tour.reserve(n);
+    for (int c: cluster_order) {
+        const std::vector<int> &cluster_tour = cluster_tours[c];
+        int m = cluster_tour.size();
+        if (m == 0) {
+            continue;
+        }
+        if (tour.empty()) {
+            tour = cluster_tour;
+            continue;
+        }
+
+        Vertex* prev = findVertex(tour.back());
+        double best = std::numeric_limits<double>::infinity();
+        int best_edge = 0;
+        bool forward = true;
+        for (int i = 0; i < m; i++) {
+            Vertex* a = findVertex(cluster_tour[i]);
+            Vertex* b = findVertex(cluster_tour[(i + 1) % m]);
+            double removed = m > 1 ? findDistance(a, b) : 0;
+            double enter_b = findDistance(prev, b) - removed; // b ... a
+            double enter_a = findDistance(prev, a) - removed; // a ... b (backwards)
+            if (enter_b < best || i == 0) {
+                best = enter_b;
+                best_edge = i;
+                forward = true;
+            }
+            if (enter_a < best) {
+                best = enter_a;
+                best_edge = i;
+                forward = false;
+            }
+        }
+
+        junctions.push_back(tour.size());
+        for (int i = 0; i < m; i++) {
+            if (forward) {
+                tour.push_back(cluster_tour[(best_edge + 1 + i) % m]);
+            } else {
+                tour.push_back(cluster_tour[((best_edge - i) % m + m) % m]);
+            }
+        }
+    }
+    junctions.push_back(0); // closing edge, from the last cluster back to the first
+
+    if (k > 1) {
+        for (int position: junctions) {
+            if (control != nullptr && control->shouldStop()) {
+                break;
+            }
+            optimizeTourWindow(tour, position, junction_window);
+            if (junction_window >= n) {
+                break; // the window covered the whole tour
+            }
+        }
+    }
+
+    tourToPath(tour, tsp_path);
+
+    double cost = 0;
+    for (std::size_t i = 0; i + 1 < tsp_path.size(); i++) {
+        cost += findDistance(tsp_path[i], tsp_path[i + 1]);
+    }
+    return cost;
+}
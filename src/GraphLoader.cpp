@@ -0,0 +1,125 @@
+#include "GraphLoader.h"
+#include "Generator.h"
+#include "Trace.h"
+#include "Utils.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+bool loader::readGraph(Graph &graph, const std::string &edges_file, const std::string &nodes_file) {
+    bool coordinate_mode = !nodes_file.empty();
+    std::ifstream edge(edges_file);
+    std::ifstream node;
+    if (coordinate_mode) {
+        node.open(nodes_file);
+    }
+
+    if (!edge.is_open() || (coordinate_mode && !node.is_open())) {
+        return false;
+    }
+
+    std::vector<int> ids, origins, dests;
+    std::vector<double> longitudes, latitudes, distances;
+    try {
+        TRACE_SPAN("parse");
+        std::string line;
+
+        if (coordinate_mode) {
+            // discard first line
+            getline(node, line);
+
+            while (getline(node, line)) {
+                if (utils::isBlank(line)) {
+                    continue;
+                }
+                std::stringstream ss(line);
+                std::string id_str, long_str, lat_str;
+
+                getline(ss, id_str, ',');
+                getline(ss, long_str, ',');
+                getline(ss, lat_str);
+
+                ids.push_back(std::stoi(id_str));
+                longitudes.push_back(std::stod(long_str));
+                latitudes.push_back(std::stod(lat_str));
+            }
+        }
+
+        // discard first line
+        getline(edge, line);
+
+        while (getline(edge, line)) {
+            if (utils::isBlank(line)) {
+                continue;
+            }
+            std::stringstream ss(line);
+            std::string origin_str, dest_str, distance;
+
+            getline(ss, origin_str, ',');
+            getline(ss, dest_str, ',');
+            getline(ss, distance);
+
+            origins.push_back(std::stoi(origin_str));
+            dests.push_back(std::stoi(dest_str));
+            distances.push_back(std::stod(distance));
+        }
+    } catch (const std::invalid_argument &) {
+        return false; // a field is not a number
+    } catch (const std::out_of_range &) {
+        return false;
+    }
+
+    TRACE_SPAN("graph-build");
+    for (std::size_t i = 0; i < ids.size(); i++) {
+        graph.addVertex(ids[i], longitudes[i], latitudes[i]);
+    }
+
+    for (std::size_t e = 0; e < origins.size(); e++) {
+        if (!coordinate_mode) {
+            // if they already exist it just exits
+            graph.addVertex(origins[e]);
+            graph.addVertex(dests[e]);
+        }
+
+        graph.addBidirectionalEdge(origins[e], dests[e], distances[e]);
+    }
+    graph.sortAdjacency();
+
+    return true;
+}
+
+bool loader::readBinaryGraph(Graph &graph, const std::string &path) {
+    generator::Instance instance;
+    {
+        TRACE_SPAN("parse");
+        if (!generator::readBinary(path, instance)) {
+            return false;
+        }
+    }
+
+    TRACE_SPAN("graph-build");
+    return buildGraph(graph, instance);
+}
+
+bool loader::buildGraph(Graph &graph, const generator::Instance &instance) {
+    bool coordinate_mode = graph.isCoordinateMode();
+    if (coordinate_mode && !instance.hasCoordinates()) {
+        return false;
+    }
+
+    for (int id = 0; id < instance.num_vertex; id++) {
+        if (coordinate_mode) {
+            graph.addVertex(id, instance.longitudes[id], instance.latitudes[id]);
+        } else {
+            graph.addVertex(id);
+        }
+    }
+
+    for (std::size_t e = 0; e < instance.getNumEdges(); e++) {
+        graph.addBidirectionalEdge(instance.origins[e], instance.dests[e], instance.weights[e]);
+    }
+    graph.sortAdjacency();
+    return true;
+}
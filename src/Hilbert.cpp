@@ -0,0 +1,115 @@
+#include "Hilbert.h"
+
+#include <algorithm>
+#include <array>
+#include <thread>
+
+uint32_t hilbert::index(uint32_t x, uint32_t y) {
+    uint64_t d = 0;
+    for (uint32_t s = 1u << (ORDER - 1); s > 0; s >>= 1) {
+        uint32_t rx = (x & s) > 0;
+        uint32_t ry = (y & s) > 0;
+        d += (uint64_t) s * s * ((3 * rx) ^ ry);
+
+        // rotate the quadrant so the sub-curve has the right orientation
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - (x & (s - 1));
+                y = s - 1 - (y & (s - 1));
+            }
+            std::swap(x, y);
+        }
+    }
+
+    return (uint32_t) d;
+}
+
+std::vector<uint32_t> hilbert::indexes(const std::vector<double> &xs, const std::vector<double> &ys) {
+    std::vector<uint32_t> result(xs.size());
+    if (xs.empty()) {
+        return result;
+    }
+
+    auto [min_x, max_x] = std::minmax_element(xs.begin(), xs.end());
+    auto [min_y, max_y] = std::minmax_element(ys.begin(), ys.end());
+
+    // same scale on both axes so the curve does not stretch the instance
+    double span = std::max(*max_x - *min_x, *max_y - *min_y);
+    double max_cell = (double) ((1u << ORDER) - 1);
+    double scale = span > 0 ? max_cell / span : 0;
+
+    for (std::size_t i = 0; i < xs.size(); i++) {
+        auto x = (uint32_t) ((xs[i] - *min_x) * scale);
+        auto y = (uint32_t) ((ys[i] - *min_y) * scale);
+        result[i] = index(x, y);
+    }
+
+    return result;
+}
+
+void hilbert::radixSort(std::vector<uint32_t> &keys, std::vector<int> &values, unsigned int num_threads) {
+    const std::size_t n = keys.size();
+    // not worth spawning threads for small inputs
+    const std::size_t min_chunk = 1 << 15;
+
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    num_threads = (unsigned int) std::max<std::size_t>(1, std::min<std::size_t>(num_threads, n / min_chunk));
+
+    std::vector<uint32_t> tmp_keys(n);
+    std::vector<int> tmp_values(n);
+    std::vector<std::array<std::size_t, 256>> count(num_threads);
+
+    auto chunk_begin = [&](unsigned int t) { return n * t / num_threads; };
+
+    auto run = [&](auto &&task) {
+        std::vector<std::thread> threads;
+        for (unsigned int t = 1; t < num_threads; t++) {
+            threads.emplace_back(task, t);
+        }
+        task(0);
+        for (auto &thread: threads) {
+            thread.join();
+        }
+    };
+
+    for (unsigned int shift = 0; shift < 32; shift += 8) {
+        run([&](unsigned int t) {
+            count[t].fill(0);
+            for (std::size_t i = chunk_begin(t); i < chunk_begin(t + 1); i++) {
+                count[t][(keys[i] >> shift) & 0xFF]++;
+            }
+        });
+
+        // turn the per thread histograms into scatter offsets (digit major, thread minor keeps the sort stable)
+        std::size_t offset = 0;
+        bool single_bucket = false;
+        for (unsigned int digit = 0; digit < 256; digit++) {
+            std::size_t digit_total = 0;
+            for (unsigned int t = 0; t < num_threads; t++) {
+                std::size_t c = count[t][digit];
+                count[t][digit] = offset;
+                offset += c;
+                digit_total += c;
+            }
+            single_bucket |= digit_total == n;
+        }
+
+        // every key shares this digit, the pass would not move anything
+        if (single_bucket) {
+            continue;
+        }
+
+        run([&](unsigned int t) {
+            for (std::size_t i = chunk_begin(t); i < chunk_begin(t + 1); i++) {
+                std::size_t pos = count[t][(keys[i] >> shift) & 0xFF]++;
+                tmp_keys[pos] = keys[i];
+                tmp_values[pos] = values[i];
+            }
+        });
+
+        keys.swap(tmp_keys);
+        values.swap(tmp_values);
+    }
+}
@@ -0,0 +1,116 @@
+#include "Instrumentation.h"
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+static const char* COUNTER_NAMES[instrument::NUM_COUNTERS] = {
+    "dijkstra_pushes", "dijkstra_relaxations", "queue_inserts", "queue_decrease_keys", "queue_extract_mins",
+    "get_edge_calls", "get_edge_probes", "haversine_calls", "two_opt_moves_evaluated", "two_opt_moves_applied",
+    "bruteforce_nodes", "bruteforce_leaves"
+};
+
+struct PhaseTotal {
+    double seconds = 0;
+    uint64_t calls = 0;
+};
+
+// Shared state, behind one mutex (only touched when threads start or finish, by phases and by reports)
+struct Registry {
+    std::mutex mutex;
+    std::vector<instrument::ThreadCounters *> live;
+    uint64_t finished[instrument::NUM_COUNTERS] = {};
+    std::map<std::string, PhaseTotal> phases;
+};
+
+// Never destroyed, so threads finishing during static destruction can still unregister
+static Registry &registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+instrument::ThreadCounters::ThreadCounters() {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.live.push_back(this);
+}
+
+instrument::ThreadCounters::~ThreadCounters() {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (int c = 0; c < NUM_COUNTERS; c++) {
+        r.finished[c] += values[c];
+    }
+    for (std::size_t i = 0; i < r.live.size(); i++) {
+        if (r.live[i] == this) {
+            r.live[i] = r.live.back();
+            r.live.pop_back();
+            break;
+        }
+    }
+}
+
+void instrument::addPhase(const char* name, double seconds) {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    PhaseTotal &phase = r.phases[name];
+    phase.seconds += seconds;
+    phase.calls++;
+}
+
+void instrument::reset() {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (ThreadCounters* counters: r.live) {
+        for (uint64_t &value: counters->values) {
+            value = 0;
+        }
+    }
+    for (uint64_t &value: r.finished) {
+        value = 0;
+    }
+    r.phases.clear();
+}
+
+uint64_t instrument::total(Counter counter) {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    uint64_t sum = r.finished[counter];
+    for (ThreadCounters* counters: r.live) {
+        sum += counters->values[counter];
+    }
+    return sum;
+}
+
+void instrument::report(std::ostream &out) {
+    if (!ENABLED) {
+        out << "{}";
+        return;
+    }
+
+    uint64_t totals[NUM_COUNTERS];
+    for (int c = 0; c < NUM_COUNTERS; c++) {
+        totals[c] = total((Counter) c);
+    }
+
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    out << "{\"counters\":{";
+    bool first = true;
+    for (int c = 0; c < NUM_COUNTERS; c++) {
+        if (totals[c] != 0) {
+            out << (first ? "" : ",") << '"' << COUNTER_NAMES[c] << "\":" << totals[c];
+            first = false;
+        }
+    }
+
+    out << "},\"phases\":{";
+    first = true;
+    for (const auto &phase: r.phases) {
+        out << (first ? "" : ",") << '"' << phase.first << "\":{\"seconds\":" << phase.second.seconds
+            << ",\"calls\":" << phase.second.calls << '}';
+        first = false;
+    }
+    out << "}}";
+}
@@ -0,0 +1,218 @@
+#include "LocalSearch.h"
+
+#include <algorithm>
+#include <deque>
+
+localsearch::Random::Random(uint64_t seed): _state(seed != 0 ? seed : 0x9E3779B97F4A7C15ull) {}
+
+uint64_t localsearch::Random::next() {
+    // xorshift64*
+    _state ^= _state >> 12;
+    _state ^= _state << 25;
+    _state ^= _state >> 27;
+    return _state * 0x2545F4914F6CDD1Dull;
+}
+
+uint32_t localsearch::Random::below(uint32_t bound) {
+    return (uint32_t) (((next() >> 32) * bound) >> 32);
+}
+
+double localsearch::Random::uniform() {
+    return (double) (next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+template<class Matrix>
+std::vector<std::vector<int>> localsearch::nearestNeighbors(const Matrix &dist, unsigned int k) {
+    int n = (int) dist.size();
+    k = std::min<unsigned int>(k, n > 0 ? n - 1 : 0);
+
+    std::vector<std::vector<int>> neighbors(n);
+    std::vector<int> candidates;
+    for (int i = 0; i < n; i++) {
+        candidates.clear();
+        for (int j = 0; j < n; j++) {
+            if (j != i) {
+                candidates.push_back(j);
+            }
+        }
+
+        std::partial_sort(candidates.begin(), candidates.begin() + k, candidates.end(), [&](int a, int b) {
+            return dist(i, a) < dist(i, b);
+        });
+        neighbors[i].assign(candidates.begin(), candidates.begin() + k);
+    }
+
+    return neighbors;
+}
+
+template<class Matrix>
+std::vector<int> localsearch::nearestNeighborTour(const Matrix &dist, int start) {
+    int n = (int) dist.size();
+    std::vector<int> tour;
+    if (n == 0) {
+        return tour;
+    }
+
+    tour.reserve(n);
+    std::vector<bool> visited(n, false);
+    int current = start;
+    visited[current] = true;
+    tour.push_back(current);
+
+    while ((int) tour.size() < n) {
+        int next = -1;
+        for (int v = 0; v < n; v++) {
+            if (!visited[v] && (next == -1 || dist(current, v) < dist(current, next))) {
+                next = v;
+            }
+        }
+        visited[next] = true;
+        tour.push_back(next);
+        current = next;
+    }
+
+    return tour;
+}
+
+void localsearch::reverse(std::vector<int> &tour, std::vector<int> &pos, int i, int j) {
+    int n = (int) tour.size();
+    int len = j - i;
+    if (len < 0) {
+        len += n;
+    }
+    len++;
+
+    if (2 * len > n) {
+        int ni = j + 1 == n ? 0 : j + 1;
+        j = i == 0 ? n - 1 : i - 1;
+        i = ni;
+        len = n - len;
+    }
+
+    for (int s = 0; s < len / 2; s++) {
+        std::swap(tour[i], tour[j]);
+        pos[tour[i]] = i;
+        pos[tour[j]] = j;
+        i = i + 1 == n ? 0 : i + 1;
+        j = j == 0 ? n - 1 : j - 1;
+    }
+}
+
+template<class Matrix>
+double localsearch::twoOpt(std::vector<int> &tour, const Matrix &dist, const std::vector<std::vector<int>> &neighbors,
+                           const std::vector<int> &active, SolveControl* control) {
+    int n = (int) tour.size();
+    if (n < 4) {
+        return 0;
+    }
+
+    std::vector<int> pos(dist.size());
+    for (int i = 0; i < n; i++) {
+        pos[tour[i]] = i;
+    }
+
+    std::vector<bool> queued(dist.size(), false);
+    std::deque<int> queue;
+    auto push = [&](int v) {
+        if (!queued[v]) {
+            queued[v] = true;
+            queue.push_back(v);
+        }
+    };
+
+    for (int v: active.empty() ? tour : active) {
+        push(v);
+    }
+
+    auto succ = [&](int v) { return tour[pos[v] + 1 == n ? 0 : pos[v] + 1]; };
+    auto pred = [&](int v) { return tour[pos[v] == 0 ? n - 1 : pos[v] - 1]; };
+
+    double total = 0;
+    while (!queue.empty()) {
+        if (control != nullptr && control->poll()) {
+            break; // every applied move kept the tour valid
+        }
+        int a = queue.front();
+        queue.pop_front();
+        queued[a] = false;
+
+        bool improved = false;
+        for (int dir = 0; dir < 2 && !improved; dir++) {
+            int b = dir == 0 ? succ(a) : pred(a);
+            double d_ab = dist(a, b);
+
+            for (int c: neighbors[a]) {
+                double d_ac = dist(a, c);
+                if (d_ac >= d_ab) {
+                    break; // neighbors are sorted, no closer candidate left
+                }
+
+                int d = dir == 0 ? succ(c) : pred(c);
+                if (c == b || d == a) {
+                    continue;
+                }
+
+                double delta = d_ac + dist(b, d) - d_ab - dist(c, d);
+                if (delta < -1e-9) {
+                    if (dir == 0) {
+                        reverse(tour, pos, pos[b], pos[c]);
+                    } else {
+                        reverse(tour, pos, pos[a], pos[d]);
+                    }
+
+                    total += delta;
+                    push(a); push(b); push(c); push(d);
+                    improved = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    return total;
+}
+
+template<class Matrix>
+double localsearch::doubleBridge(std::vector<int> &tour, const Matrix &dist, Random &rng, std::vector<int> &endpoints) {
+    // a local window keeps the kick small, so the 2-opt repair only has to look at a few vertexes
+    const int max_window = 50;
+
+    int n = (int) tour.size();
+    int window = std::min(n, max_window);
+
+    std::rotate(tour.begin(), tour.begin() + rng.below(n), tour.end());
+
+    // three distinct cuts in [1, window)
+    int cuts[3];
+    do {
+        for (int &cut: cuts) {
+            cut = 1 + (int) rng.below(window - 1);
+        }
+        std::sort(cuts, cuts + 3);
+    } while (cuts[0] == cuts[1] || cuts[1] == cuts[2]);
+
+    int p1 = cuts[0], p2 = cuts[1], p3 = cuts[2];
+    int a_end = tour[p1 - 1], b_start = tour[p1];
+    int b_end = tour[p2 - 1], c_start = tour[p2];
+    int c_end = tour[p3 - 1], d_start = tour[p3 % n];
+
+    double delta = (double) dist(a_end, c_start) + dist(c_end, b_start) + dist(b_end, d_start)
+                 - dist(a_end, b_start) - dist(b_end, c_start) - dist(c_end, d_start);
+
+    std::rotate(tour.begin() + p1, tour.begin() + p2, tour.begin() + p3);
+
+    endpoints = {a_end, b_start, b_end, c_start, c_end, d_start};
+    return delta;
+}
+
+#define INSTANTIATE_KERNELS(Matrix) \
+    template std::vector<std::vector<int>> localsearch::nearestNeighbors(const Matrix &, unsigned int); \
+    template std::vector<int> localsearch::nearestNeighborTour(const Matrix &, int); \
+    template double localsearch::twoOpt(std::vector<int> &, const Matrix &, const std::vector<std::vector<int>> &, \
+                                        const std::vector<int> &, SolveControl*); \
+    template double localsearch::doubleBridge(std::vector<int> &, const Matrix &, Random &, std::vector<int> &);
+
+INSTANTIATE_KERNELS(BasicDistanceMatrix<float>)
+INSTANTIATE_KERNELS(BasicDistanceMatrix<int32_t>)
+INSTANTIATE_KERNELS(BasicDistanceMatrix<double>)
+INSTANTIATE_KERNELS(TiledDistanceMatrix)
@@ -1,12 +1,25 @@
 #include "Menu.h"
+#include "Allocations.h"
+#include "ContractionHierarchy.h"
+#include "GraphLoader.h"
+#include "Instrumentation.h"
 #include "Utils.h"
 
 #include <chrono>
-#include <fstream>
+#include <cstdlib>
+#include <filesystem>
+#include <future>
+#include <iomanip>
 #include <iostream>
+#include <limits>
 #include <sstream>
 #include <string>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <poll.h>
+#include <unistd.h>
+#endif
+
 // To work with `Real-World-Graphs` import '../data/Real-World-Graphs/graph{x}/edges.csv'
 // To work with `Real-World-Graphs` import '../data/Extra_Fully_Connected_Graphs/edges_{x}.csv'
 // To work with `Toy-Graphs` import '../data/Toy-Graphs/{file}.csv'
@@ -16,93 +29,132 @@
 // std::string Menu::NODE_FILE;
 
 void Menu::readData(bool coordinateMode) {
-    if (!coordinateMode) {
-        std::ifstream input(INPUT_FILE);
-
-        if (!input.is_open()) {
-            std::cout << "Error opening the file\n";
-            exit(1);
-        }
-
-        std::string line;
-
-        //discard first line
-        getline(input, line);
-
-        while (getline(input, line)) {
-            std::stringstream ss(line);
-            std::string origin_str, dest_str, distance;
-
-            getline(ss, origin_str, ',');
-            getline(ss, dest_str, ',');
-            getline(ss, distance);
-
-            if (line.back() == '\r' || line.back() == '\n') {
-                line.pop_back(); // remove '\n' or '\r'
-            }
-
-            int origin = std::stoi(origin_str);
-            int dest = std::stoi(dest_str);
+    if (!loader::readGraph(_graph, INPUT_FILE, coordinateMode ? NODE_FILE : "")) {
+        std::cout << (coordinateMode ? "Error opening a file\n" : "Error opening the file\n");
+        exit(1);
+    }
+}
 
-            // if they already exist it just exits
-            _graph.addVertex(origin);
-            _graph.addVertex(dest);
+// Print the counters, phases and allocations of the last solve (instrumented or allocation tracking builds only)
+static void printProfile() {
+    if (instrument::ENABLED) {
+        std::cout << "Profile: ";
+        instrument::report(std::cout);
+        std::cout << "\n\n";
+    }
+    if (allocation::ENABLED) {
+        std::cout << "Allocations: ";
+        allocation::report(std::cout);
+        std::cout << "\n\n";
+    }
+}
 
-            _graph.addBidirectionalEdge(origin, dest, std::stod(distance));
-        }
+// Print the vertex ids of a path, separated by arrows
+static void printPath(const std::vector<Vertex *> &path) {
+    for (std::size_t i = 0; i < path.size(); i++) {
+        std::cout << path[i]->getId() << (i + 1 == path.size() ? "\n" : " -> ");
+    }
+}
 
-        input.close();
+// Directory for files derived from the datasets ($XDG_CACHE_HOME/feup_da2, ~/.cache/feup_da2 or the temporary
+// directory), created if missing (empty if none can be created)
+static std::filesystem::path cacheDirectory() {
+    namespace fs = std::filesystem;
+    std::error_code error;
+    fs::path base;
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg != nullptr && *xdg != '\0') {
+        base = xdg;
+    } else if (const char* home = std::getenv("HOME"); home != nullptr && *home != '\0') {
+        base = fs::path(home) / ".cache";
     } else {
-        std::ifstream node(NODE_FILE);
-        std::ifstream edge(INPUT_FILE);
-
-        if (!node.is_open() || !edge.is_open()) {
-            std::cout << "Error opening a file\n";
-            exit(1);
-        }
+        base = fs::temp_directory_path(error);
+    }
 
-        std::string line;
+    fs::path dir = base / "feup_da2";
+    fs::create_directories(dir, error);
+    return error ? fs::path() : dir;
+}
 
-        // discard first line
-        getline(node, line);
-        getline(edge, line);
+// If a stream (0 for the input, 1 for the output) is an interactive terminal
+static bool isTerminal(int fd) {
+#if defined(__unix__) || defined(__APPLE__)
+    return isatty(fd);
+#else
+    return false;
+#endif
+}
 
-        while (getline(node, line)) {
-            std::stringstream ss(line);
-            std::string id_str, long_str, lat_str;
+// Wait until a line is typed on the terminal or the timeout ends
+static bool waitForLine(int timeout_ms) {
+#if defined(__unix__) || defined(__APPLE__)
+    pollfd input = {STDIN_FILENO, POLLIN, 0};
+    return poll(&input, 1, timeout_ms) > 0;
+#else
+    return false;
+#endif
+}
 
-            getline(ss, id_str, ',');
-            getline(ss, long_str, ',');
-            getline(ss, lat_str);
+double Menu::runSolver(const std::function<double()> &solve, const char* work_unit, SolveControl &control) {
+    using clock = std::chrono::steady_clock;
+    const int refresh_ms = 200;
+
+    // the solve runs on its own thread, which publishes the work it batched in SolveControl::poll when it ends
+    std::future<double> result = std::async(std::launch::async, [&solve, &control]() {
+        double cost = solve();
+        control.flush();
+        return cost;
+    });
+    bool show = isTerminal(1);
+    bool cancellable = work_unit != nullptr && isTerminal(0);
+    if (cancellable) {
+        std::cout << "Solving, press Enter to stop and keep the best tour found so far\n";
+    }
 
-            if (line.back() == '\r' || line.back() == '\n') {
-                line.pop_back(); // remove '\n' or '\r'
+    auto start = clock::now();
+    auto last = start;
+    uint64_t last_work = 0;
+    std::size_t line_length = 0;
+    while (true) {
+        if (cancellable && !control.isStopped()) {
+            if (waitForLine(refresh_ms)) {
+                control.cancel();
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
             }
-
-            _graph.addVertex(std::stoi(id_str), std::stod(long_str), std::stod(lat_str));
-        }
-
-        while (getline(edge, line)) {
-            std::stringstream ss(line);
-            std::string origin_str, dest_str, distance;
-
-            getline(ss, origin_str, ',');
-            getline(ss, dest_str, ',');
-            getline(ss, distance);
-
-            if (line.back() == '\r' || line.back() == '\n') {
-                line.pop_back(); // remove '\n' or '\r'
+            if (result.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+                break;
             }
+        } else if (result.wait_for(std::chrono::milliseconds(refresh_ms)) == std::future_status::ready) {
+            break;
+        }
+        if (!show) {
+            continue;
+        }
 
-            int origin = std::stoi(origin_str);
-            int dest = std::stoi(dest_str);
-
-            _graph.addBidirectionalEdge(origin, dest, std::stod(distance));
+        auto now = clock::now();
+        std::ostringstream line;
+        line.precision(1);
+        line << std::fixed << std::chrono::duration<double>(now - start).count() << " s";
+        if (work_unit != nullptr) {
+            uint64_t work = control.getWork();
+            double rate = (work - last_work) / std::chrono::duration<double>(now - last).count();
+            line << " | best " << control.getBestCost() << " | " << work << ' ' << work_unit << " | "
+                 << rate << ' ' << work_unit << "/s";
+            last_work = work;
         }
+        if (control.isStopped()) {
+            line << " | stopping";
+        }
+        last = now;
+        std::string text = line.str();
+        std::cout << '\r' << text << std::string(line_length > text.size() ? line_length - text.size() : 0, ' ')
+                  << std::flush;
+        line_length = text.size();
+    }
 
-        node.close();
-        edge.close();
+    if (line_length > 0) {
+        std::cout << '\r' << std::string(line_length, ' ') << '\r';
     }
+    return result.get();
 }
 
 void Menu::calculateBruteforceTSP() {
@@ -113,18 +165,23 @@ void Menu::calculateBruteforceTSP() {
 
     std::vector<Vertex *> tsp_path;
 
+    SolveControl control;
+    INSTRUMENT_RESET();
+    ALLOCATIONS_RESET();
     auto start = std::chrono::high_resolution_clock::now();
-    double cost = _graph.tspBruteforce(tsp_path);
+    double cost = runSolver([&]() { return _graph.tspBruteforce(tsp_path, &control); }, "nodes", control);
     auto end = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> duration = end - start;
 
     std::cout << "TSP Path (Brute Force Algorithm):";
-    for (int i = 0; i < tsp_path.size(); i++) {
-        std::cout << tsp_path[i]->getId() << (i == tsp_path.size() - 1 ? "\n" : " -> ");
-    }
+    printPath(tsp_path);
 
-    std::cout << "Cost: " << cost << '\n';
-    std::cout << "Elapsed Time: " << duration.count() << " s\n\n";   
+    std::cout << "Cost: " << cost << (control.isOptimal() ? " (optimal)" : "") << '\n';
+    if (control.isStopped()) {
+        std::cout << "Stopped early, best tour found so far\n";
+    }
+    std::cout << "Elapsed Time: " << duration.count() << " s\n\n";
+    printProfile();
 }
 
 void Menu::calculateTriangularApproximation() {
@@ -135,20 +192,22 @@ void Menu::calculateTriangularApproximation() {
 
     std::vector<Vertex *> tsp_path;
 
+    SolveControl control;
+    INSTRUMENT_RESET();
+    ALLOCATIONS_RESET();
     auto start = std::chrono::high_resolution_clock::now();
 
-    double cost = _graph.triangularApproximation(tsp_path);
+    double cost = runSolver([&]() { return _graph.triangularApproximation(tsp_path); }, nullptr, control);
 
     auto end = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> duration = end - start;
 
     std::cout << "Path: ";
-    for (int i = 0; i < tsp_path.size(); i++) {
-        std::cout << tsp_path[i]->getId() << (i == tsp_path.size() - 1 ? "\n" : " -> ");
-    }
+    printPath(tsp_path);
 
     std::cout << "Cost: " << cost << "\n";
     std::cout << "Elapsed Time: " << duration.count() << " s\n\n";
+    printProfile();
 }
 
 
@@ -165,20 +224,273 @@ void Menu::calculateNearestNeighborTSP() {
 
     std::vector<Vertex*> tsp_path;
 
+    SolveControl control;
+    INSTRUMENT_RESET();
+    ALLOCATIONS_RESET();
     auto start = std::chrono::high_resolution_clock::now();
 
-    double cost = _graph.tspNearestNeighbor(tsp_path, iterations);
+    double cost = runSolver([&]() { return _graph.tspNearestNeighbor(tsp_path, iterations, &control); }, "moves", control);
 
     auto end = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> duration = end - start;
 
     std::cout << "TSP Path (Nearest Neighbor): ";
-    for (int i = 0; i < tsp_path.size(); i++) {
-        std::cout << tsp_path[i]->getId() << (i == tsp_path.size() - 1 ? "\n" : " -> ");
+    printPath(tsp_path);
+
+    std::cout << "Cost: " << cost << '\n';
+    if (control.isStopped()) {
+        std::cout << "Stopped early, best tour found so far\n";
+    }
+    std::cout << "Elapsed Time: " << duration.count() << " s\n\n";
+    printProfile();
+}
+
+void Menu::calculateHilbertCurveTSP() {
+    if (!_graph_selected) {
+        std::cout << "No graph selected. Please select a graph first.\n\n";
+        return;
+    }
+
+    if (!_graph.isCoordinateMode()) {
+        std::cout << "The Hilbert curve needs vertex coordinates. Please select a Real-World-Graph.\n\n";
+        return;
     }
 
+    unsigned int two_opt;
+    std::cout << "Improve the tour with the 2opt algorithm (0 no, 1 yes): ";
+    std::cin >> two_opt;
+
+    std::vector<Vertex*> tsp_path;
+
+    SolveControl control;
+    INSTRUMENT_RESET();
+    ALLOCATIONS_RESET();
+    auto start = std::chrono::high_resolution_clock::now();
+
+    double cost = runSolver([&]() { return _graph.tspHilbertCurve(tsp_path, two_opt != 0, &control); }, "moves", control);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> duration = end - start;
+
+    std::cout << "TSP Path (Hilbert Curve): ";
+    printPath(tsp_path);
+
+    std::cout << "Cost: " << cost << '\n';
+    if (control.isStopped()) {
+        std::cout << "Stopped early, best tour found so far\n";
+    }
+    std::cout << "Elapsed Time: " << duration.count() << " s\n\n";
+    printProfile();
+}
+
+void Menu::calculateInsertionTSP(bool farthest) {
+    if (!_graph_selected) {
+        std::cout << "No graph selected. Please select a graph first.\n\n";
+        return;
+    }
+
+    std::vector<Vertex*> tsp_path;
+
+    SolveControl control;
+    INSTRUMENT_RESET();
+    ALLOCATIONS_RESET();
+    auto start = std::chrono::high_resolution_clock::now();
+
+    double cost = runSolver([&]() {
+        return farthest ? _graph.tspFarthestInsertion(tsp_path) : _graph.tspCheapestInsertion(tsp_path);
+    }, nullptr, control);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> duration = end - start;
+
+    std::cout << (farthest ? "TSP Path (Farthest Insertion): " : "TSP Path (Cheapest Insertion): ");
+    printPath(tsp_path);
+
     std::cout << "Cost: " << cost << '\n';
     std::cout << "Elapsed Time: " << duration.count() << " s\n\n";
+    printProfile();
+}
+
+void Menu::calculateIteratedLocalSearchTSP() {
+    if (!_graph_selected) {
+        std::cout << "No graph selected. Please select a graph first.\n\n";
+        return;
+    }
+
+    double time_limit;
+    std::cout << "Time limit in seconds: ";
+    std::cin >> time_limit;
+
+    unsigned int threads;
+    std::cout << "Number of threads (0 to use every core): ";
+    std::cin >> threads;
+
+    std::vector<Vertex*> tsp_path;
+
+    SolveControl control;
+    INSTRUMENT_RESET();
+    ALLOCATIONS_RESET();
+    auto start = std::chrono::high_resolution_clock::now();
+
+    double cost = runSolver([&]() {
+        return _graph.tspIteratedLocalSearch(tsp_path, time_limit, threads, &control);
+    }, "kicks", control);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> duration = end - start;
+
+    std::cout << "TSP Path (Iterated Local Search): ";
+    printPath(tsp_path);
+
+    std::cout << "Cost: " << cost << '\n';
+    if (control.isStopped()) {
+        std::cout << "Stopped early, best tour found so far\n";
+    }
+    std::cout << "Elapsed Time: " << duration.count() << " s\n\n";
+    printProfile();
+}
+
+void Menu::calculateSimulatedAnnealingTSP() {
+    if (!_graph_selected) {
+        std::cout << "No graph selected. Please select a graph first.\n\n";
+        return;
+    }
+
+    double time_limit;
+    std::cout << "Time limit in seconds: ";
+    std::cin >> time_limit;
+
+    unsigned int threads;
+    std::cout << "Number of threads, one replica each (0 to use every core): ";
+    std::cin >> threads;
+
+    std::vector<Vertex*> tsp_path;
+    double moves_per_second;
+
+    SolveControl control;
+    INSTRUMENT_RESET();
+    ALLOCATIONS_RESET();
+    auto start = std::chrono::high_resolution_clock::now();
+
+    double cost = runSolver([&]() {
+        return _graph.tspSimulatedAnnealing(tsp_path, time_limit, threads, moves_per_second, &control);
+    }, "moves", control);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> duration = end - start;
+
+    std::cout << "TSP Path (Simulated Annealing): ";
+    printPath(tsp_path);
+
+    std::cout << "Cost: " << cost << '\n';
+    if (control.isStopped()) {
+        std::cout << "Stopped early, best tour found so far\n";
+    }
+    std::cout << "Moves per second: " << moves_per_second << '\n';
+    std::cout << "Elapsed Time: " << duration.count() << " s\n\n";
+    printProfile();
+}
+
+void Menu::calculateClusterDecompositionTSP() {
+    if (!_graph_selected) {
+        std::cout << "No graph selected. Please select a graph first.\n\n";
+        return;
+    }
+
+    unsigned int cluster_size;
+    std::cout << "Vertexes per cluster: ";
+    std::cin >> cluster_size;
+
+    unsigned int threads;
+    std::cout << "Number of threads (0 to use every core): ";
+    std::cin >> threads;
+
+    std::vector<Vertex*> tsp_path;
+
+    SolveControl control;
+    INSTRUMENT_RESET();
+    ALLOCATIONS_RESET();
+    auto start = std::chrono::high_resolution_clock::now();
+
+    double cost = runSolver([&]() {
+        return _graph.tspClusterDecomposition(tsp_path, cluster_size, threads, &control);
+    }, "clusters", control);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> duration = end - start;
+
+    std::cout << "TSP Path (Cluster Decomposition): ";
+    printPath(tsp_path);
+
+    std::cout << "Cost: " << cost << '\n';
+    if (control.isStopped()) {
+        std::cout << "Stopped early, best tour found so far\n";
+    }
+    std::cout << "Elapsed Time: " << duration.count() << " s\n\n";
+    printProfile();
+}
+
+void Menu::calculateShortestPath() {
+    if (!_graph_selected) {
+        std::cout << "No graph selected. Please select a graph first.\n\n";
+        return;
+    }
+
+    int source, dest;
+    std::cout << "Source vertex: ";
+    std::cin >> source;
+    std::cout << "Destination vertex: ";
+    std::cin >> dest;
+
+    if (_graph.findVertex(source) == nullptr || _graph.findVertex(dest) == nullptr) {
+        std::cout << "Vertex not found.\n\n";
+        return;
+    }
+
+    INSTRUMENT_RESET();
+    ALLOCATIONS_RESET();
+    auto start = std::chrono::high_resolution_clock::now();
+
+    if (!ContractionHierarchy::isSparse(_graph)) {
+        // contracting a dense graph takes far longer than any query it would speed up
+        double cost = _graph.bidirectionalDijkstra(_graph.findVertex(source), _graph.findVertex(dest));
+        std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - start;
+        std::cout << "Graph too dense for a contraction hierarchy, used bidirectional Dijkstra\n";
+        std::cout << "Cost: " << cost << '\n';
+        std::cout << "Elapsed Time: " << duration.count() << " s\n\n";
+        printProfile();
+        return;
+    }
+
+    // the file is named after the edges it was built from, so an edited dataset never reuses a stale hierarchy
+    uint64_t fingerprint = ContractionHierarchy::fingerprint(_graph);
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << fingerprint << ".ch";
+    std::filesystem::path cache = cacheDirectory();
+    std::string hierarchy_file = cache.empty() ? "" : (cache / name.str()).string();
+
+    ContractionHierarchy hierarchy;
+    bool loaded = !hierarchy_file.empty() && hierarchy.load(hierarchy_file) && hierarchy.getFingerprint() == fingerprint
+                  && hierarchy.getNumVertex() == _graph.getNumVertex();
+    if (!loaded) {
+        hierarchy = ContractionHierarchy(_graph);
+        if (hierarchy_file.empty() || !hierarchy.save(hierarchy_file)) {
+            std::cout << "Could not save the hierarchy to the cache directory\n";
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> preprocessing = end - start;
+
+    start = std::chrono::high_resolution_clock::now();
+    double cost = hierarchy.query(source, dest);
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> duration = end - start;
+
+    std::cout << (loaded ? "Hierarchy loaded in " : "Hierarchy built in ") << preprocessing.count() << " s ("
+              << hierarchy.getNumEdges() << " edges)\n";
+    std::cout << "Cost: " << cost << '\n';
+    std::cout << "Elapsed Time: " << duration.count() << " s\n\n";
+    printProfile();
 }
 
 
@@ -510,7 +822,14 @@ void Menu::algorithmSelectionMenu() {
         std::cout << "1. Calculate TSP (Brute Force)\n";
         std::cout << "2. Calculate TSP (Triangular Approximation Heuristic) \n";
         std::cout << "3. Calculate TSP (Nearest Neighbor)\n";
-        std::cout << "4. Back\n";
+        std::cout << "4. Calculate TSP (Hilbert Curve)\n";
+        std::cout << "5. Calculate TSP (Cheapest Insertion)\n";
+        std::cout << "6. Calculate TSP (Farthest Insertion)\n";
+        std::cout << "7. Calculate TSP (Iterated Local Search)\n";
+        std::cout << "8. Calculate TSP (Simulated Annealing)\n";
+        std::cout << "9. Calculate TSP (Cluster Decomposition)\n";
+        std::cout << "10. Shortest Path (Contraction Hierarchy)\n";
+        std::cout << "11. Back\n";
         std::cout << "Enter your choice: ";
 
         int choice;
@@ -539,6 +858,55 @@ void Menu::algorithmSelectionMenu() {
                 utils::waitEnter();
                 break;
             case 4:
+                utils::clearScreen();
+                std::cout << "Selected TSP (Hilbert Curve) Algorithm.\n\n";
+                calculateHilbertCurveTSP();
+                _algorithm_selected = true;
+                utils::waitEnter();
+                break;
+            case 5:
+                utils::clearScreen();
+                std::cout << "Selected TSP (Cheapest Insertion) Algorithm.\n\n";
+                calculateInsertionTSP(false);
+                _algorithm_selected = true;
+                utils::waitEnter();
+                break;
+            case 6:
+                utils::clearScreen();
+                std::cout << "Selected TSP (Farthest Insertion) Algorithm.\n\n";
+                calculateInsertionTSP(true);
+                _algorithm_selected = true;
+                utils::waitEnter();
+                break;
+            case 7:
+                utils::clearScreen();
+                std::cout << "Selected TSP (Iterated Local Search) Algorithm.\n\n";
+                calculateIteratedLocalSearchTSP();
+                _algorithm_selected = true;
+                utils::waitEnter();
+                break;
+            case 8:
+                utils::clearScreen();
+                std::cout << "Selected TSP (Simulated Annealing) Algorithm.\n\n";
+                calculateSimulatedAnnealingTSP();
+                _algorithm_selected = true;
+                utils::waitEnter();
+                break;
+            case 9:
+                utils::clearScreen();
+                std::cout << "Selected TSP (Cluster Decomposition) Algorithm.\n\n";
+                calculateClusterDecompositionTSP();
+                _algorithm_selected = true;
+                utils::waitEnter();
+                break;
+            case 10:
+                utils::clearScreen();
+                std::cout << "Selected Shortest Path (Contraction Hierarchy).\n\n";
+                calculateShortestPath();
+                _algorithm_selected = true;
+                utils::waitEnter();
+                break;
+            case 11:
                 return;
             default:
                 utils::clearScreen();
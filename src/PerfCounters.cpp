@@ -0,0 +1,154 @@
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+static const char* EVENT_NAMES[PerfCounters::NUM_EVENTS] = {
+    "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses", "page_faults"
+};
+
+#ifdef __linux__
+// Open one event for the calling thread and its future children, disabled until start enables it
+static int openEvent(PerfCounters::Event event) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    switch (event) {
+        case PerfCounters::CYCLES:
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PerfCounters::INSTRUCTIONS:
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PerfCounters::L1D_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                        | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case PerfCounters::LLC_MISSES:
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        case PerfCounters::BRANCH_MISSES:
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        default:
+            attr.type = PERF_TYPE_SOFTWARE;
+            attr.config = PERF_COUNT_SW_PAGE_FAULTS;
+            break;
+    }
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+PerfCounters::PerfCounters() {
+    for (int e = 0; e < NUM_EVENTS; e++) {
+        _fds[e] = -1;
+        _values[e] = -1;
+    }
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (int &fd: _fds) {
+        if (fd != -1) {
+            close(fd);
+            fd = -1;
+        }
+    }
+#endif
+}
+
+bool PerfCounters::start() {
+    bool any = false;
+#ifdef __linux__
+    for (int e = 0; e < NUM_EVENTS; e++) {
+        _values[e] = -1;
+        _fds[e] = openEvent((Event) e);
+        any |= _fds[e] != -1;
+    }
+    // enabled last, so opening the later events is not counted by the earlier ones
+    for (int fd: _fds) {
+        if (fd != -1) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+    return any;
+}
+
+void PerfCounters::stop() {
+#ifdef __linux__
+    for (int fd: _fds) {
+        if (fd != -1) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    for (int e = 0; e < NUM_EVENTS; e++) {
+        if (_fds[e] == -1) {
+            continue;
+        }
+
+        uint64_t data[3]; // value, time enabled, time running
+        if (read(_fds[e], data, sizeof(data)) == (ssize_t) sizeof(data) && data[2] > 0) {
+            // scale up when the counter only ran part of the time (multiplexing)
+            _values[e] = (int64_t) ((double) data[0] * data[1] / data[2]);
+        }
+        close(_fds[e]);
+        _fds[e] = -1;
+    }
+#endif
+}
+
+int64_t PerfCounters::get(Event event) const {
+    return _values[event];
+}
+
+const char* PerfCounters::getName(Event event) {
+    return EVENT_NAMES[event];
+}
+
+void PerfCounters::writeJson(std::ostream &out, std::size_t num_vertex, std::size_t num_edges) const {
+    auto ratio = [&](int64_t numerator, double denominator) {
+        if (numerator < 0 || denominator <= 0) {
+            out << "null";
+        } else {
+            out << numerator / denominator;
+        }
+    };
+
+    out << '{';
+    for (int e = 0; e < NUM_EVENTS; e++) {
+        out << '"' << EVENT_NAMES[e] << "\":";
+        if (_values[e] < 0) {
+            out << "null";
+        } else {
+            out << _values[e];
+        }
+        out << ',';
+    }
+
+    out << "\"ipc\":";
+    ratio(_values[INSTRUCTIONS], _values[CYCLES] > 0 ? (double) _values[CYCLES] : 0);
+    for (Event e: {L1D_MISSES, LLC_MISSES, BRANCH_MISSES}) {
+        out << ",\"" << EVENT_NAMES[e] << "_per_vertex\":";
+        ratio(_values[e], (double) num_vertex);
+        out << ",\"" << EVENT_NAMES[e] << "_per_edge\":";
+        ratio(_values[e], (double) num_edges);
+    }
+    out << '}';
+}
@@ -0,0 +1,72 @@
+#include "Reordering.h"
+#include "Hilbert.h"
+
+#include <algorithm>
+#include <numeric>
+
+std::vector<int> reordering::reverseCuthillMcKee(const CompactGraph &graph) {
+    int n = graph.getNumVertex();
+    auto degree = [&](int v) { return graph.edgesEnd(v) - graph.edgesBegin(v); };
+
+    // components start from their lowest degree vertex, so every start is tried in increasing degree order
+    std::vector<int> starts(n);
+    std::iota(starts.begin(), starts.end(), 0);
+    std::stable_sort(starts.begin(), starts.end(), [&](int a, int b) { return degree(a) < degree(b); });
+
+    std::vector<int> order;
+    order.reserve(n);
+    std::vector<bool> visited(n, false);
+    std::vector<int> neighbors;
+    for (int start: starts) {
+        if (visited[start]) {
+            continue;
+        }
+
+        visited[start] = true;
+        std::size_t head = order.size();
+        order.push_back(start);
+        while (head < order.size()) {
+            int u = order[head++];
+            neighbors.clear();
+            for (int e = graph.edgesBegin(u); e < graph.edgesEnd(u); e++) {
+                int v = graph.getTarget(e);
+                if (!visited[v]) {
+                    visited[v] = true;
+                    neighbors.push_back(v);
+                }
+            }
+            std::sort(neighbors.begin(), neighbors.end(), [&](int a, int b) { return degree(a) < degree(b); });
+            order.insert(order.end(), neighbors.begin(), neighbors.end());
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+std::vector<int> reordering::hilbertOrder(const CompactGraph &graph) {
+    int n = graph.getNumVertex();
+    std::vector<double> xs(n), ys(n);
+    for (int v = 0; v < n; v++) {
+        xs[v] = graph.getLong(v);
+        ys[v] = graph.getLat(v);
+    }
+
+    std::vector<uint32_t> keys = hilbert::indexes(xs, ys);
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    hilbert::radixSort(keys, order);
+    return order;
+}
+
+std::vector<int> reordering::localityOrder(const CompactGraph &graph) {
+    return graph.hasCoordinates() ? hilbertOrder(graph) : reverseCuthillMcKee(graph);
+}
+
+std::vector<int> reordering::inverse(const std::vector<int> &order) {
+    std::vector<int> rank(order.size());
+    for (std::size_t i = 0; i < order.size(); i++) {
+        rank[order[i]] = (int) i;
+    }
+    return rank;
+}
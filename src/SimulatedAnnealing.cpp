@@ -0,0 +1,323 @@
+#include "SimulatedAnnealing.h"
+#include "LocalSearch.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+// State of one annealing chain
+struct Replica {
+    std::vector<int> tour;
+    std::vector<int> pos;
+    double cost;
+    std::vector<int> best_tour;
+    double best_cost;
+    unsigned long long evaluated = 0;
+    unsigned long long accepted = 0;
+};
+
+// Reusable barrier for a fixed number of threads (std::barrier is C++20)
+class RoundBarrier {
+private:
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    unsigned int _count;
+    unsigned int _waiting = 0;
+    unsigned long long _generation = 0;
+
+public:
+    explicit RoundBarrier(unsigned int count): _count(count) {}
+
+    // Block until every thread called wait for this generation
+    void wait() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        unsigned long long generation = _generation;
+        if (++_waiting == _count) {
+            _waiting = 0;
+            _generation++;
+            _cv.notify_all();
+        } else {
+            _cv.wait(lock, [&]() { return generation != _generation; });
+        }
+    }
+};
+
+// Number of neighbors each move chooses from
+static const unsigned int NUM_NEIGHBORS = 10;
+
+// Moves each replica makes between replica exchanges
+static const unsigned int MOVES_PER_ROUND = 20000;
+
+// Ratio between the temperatures of the hottest and the coldest replica
+static const double LADDER_SPAN = 10.0;
+
+// Random moves used to calibrate the starting temperature
+static const unsigned int CALIBRATION_MOVES = 1000;
+
+// Run moves on a replica at a fixed temperature (temperature 0 only accepts improvements).
+// Every move is between a random vertex a and one of its neighbors c:
+//  0. 2-opt:  a b ... c d -> a c ... b d
+//  1. swap:   exchange the positions of a and c
+//  2. insert: move a to between c and its successor
+// Returns the sum of the positive deltas seen (used for calibration)
+template<class Matrix>
+static double anneal(Replica &r, const Matrix &dist, const std::vector<std::vector<int>> &neighbors,
+                     localsearch::Random &rng, double temperature, unsigned int moves, bool apply) {
+    auto &tour = r.tour;
+    auto &pos = r.pos;
+    int n = (int) tour.size();
+    unsigned int k = neighbors[0].size();
+
+    auto succ = [&](int v) { return tour[pos[v] + 1 == n ? 0 : pos[v] + 1]; };
+    auto pred = [&](int v) { return tour[pos[v] == 0 ? n - 1 : pos[v] - 1]; };
+
+    double uphill = 0;
+    for (unsigned int m = 0; m < moves; m++) {
+        int a = (int) rng.below(n);
+        int c = neighbors[a][rng.below(k)];
+        unsigned int move = rng.below(3);
+
+        double delta;
+        int b = 0, d = 0;
+        if (move == 0) {
+            b = succ(a);
+            d = succ(c);
+            if (c == b || d == a) {
+                continue;
+            }
+            delta = dist(a, c) + dist(b, d) - dist(a, b) - dist(c, d);
+        } else if (move == 1) {
+            int pa = pred(a), sa = succ(a), pc = pred(c), sc = succ(c);
+            if (sa == c) {
+                delta = dist(pa, c) + dist(a, sc) - dist(pa, a) - dist(c, sc);
+            } else if (sc == a) {
+                delta = dist(pc, a) + dist(c, sa) - dist(pc, c) - dist(a, sa);
+            } else {
+                delta = dist(pa, c) + dist(c, sa) + dist(pc, a) + dist(a, sc)
+                      - dist(pa, a) - dist(a, sa) - dist(pc, c) - dist(c, sc);
+            }
+        } else {
+            int p = pred(a), s = succ(a);
+            d = succ(c);
+            if (c == p) {
+                continue;
+            }
+            delta = dist(p, s) - dist(p, a) - dist(a, s) + dist(c, a) + dist(a, d) - dist(c, d);
+        }
+
+        r.evaluated++;
+        if (delta > 0) {
+            uphill += delta;
+        }
+        if (!apply || (delta > 0 && (temperature <= 0 || rng.uniform() >= std::exp(-delta / temperature)))) {
+            continue;
+        }
+
+        if (delta > 0 && r.cost < r.best_cost - 1e-9) {
+            // leaving the best tour seen by this replica, keep it before it is lost
+            r.best_tour = tour;
+            r.best_cost = r.cost;
+        }
+        r.accepted++;
+        r.cost += delta;
+        if (move == 0) {
+            localsearch::reverse(tour, pos, pos[b], pos[c]);
+        } else if (move == 1) {
+            std::swap(tour[pos[a]], tour[pos[c]]);
+            std::swap(pos[a], pos[c]);
+        } else {
+            // shift the shorter side of the tour by one position
+            int i = pos[a];
+            int forward = pos[c] - i;
+            if (forward < 0) {
+                forward += n;
+            }
+            int backward = i - pos[d];
+            if (backward < 0) {
+                backward += n;
+            }
+
+            if (forward <= backward) {
+                for (int t = 0; t < forward; t++) {
+                    int next = i + 1 == n ? 0 : i + 1;
+                    tour[i] = tour[next];
+                    pos[tour[i]] = i;
+                    i = next;
+                }
+            } else {
+                for (int t = 0; t < backward; t++) {
+                    int prev = i == 0 ? n - 1 : i - 1;
+                    tour[i] = tour[prev];
+                    pos[tour[i]] = i;
+                    i = prev;
+                }
+            }
+            tour[i] = a;
+            pos[a] = i;
+        }
+    }
+
+    return uphill;
+}
+
+template<class Matrix>
+BasicSimulatedAnnealing<Matrix>::BasicSimulatedAnnealing(const Matrix &dist)
+    : _dist(dist), _neighbors(localsearch::nearestNeighbors(dist, NUM_NEIGHBORS)) {}
+
+template<class Matrix>
+BasicSimulatedAnnealing<Matrix>::BasicSimulatedAnnealing(const Matrix &dist, std::vector<std::vector<int>> neighbors)
+    : _dist(dist), _neighbors(std::move(neighbors)) {}
+
+template<class Matrix>
+double BasicSimulatedAnnealing<Matrix>::run(std::vector<int> &tour, double time_limit, unsigned int num_replicas, SolveControl* control) {
+    TRACE_SPAN("annealing");
+    if (control != nullptr) {
+        time_limit = control->getRemaining(time_limit);
+    }
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+    auto elapsed = [&]() { return std::chrono::duration<double>(clock::now() - start).count(); };
+
+    _moves_evaluated = 0;
+    _moves_accepted = 0;
+    _elapsed = 0;
+
+    int n = (int) tour.size();
+    double cost = _dist.tourCost(tour);
+    if (n < 8) {
+        return cost;
+    }
+    num_replicas = std::max(1u, num_replicas);
+
+    std::vector<Replica> replicas(num_replicas);
+    std::vector<localsearch::Random> rngs;
+    for (unsigned int r = 0; r < num_replicas; r++) {
+        replicas[r].tour = tour;
+        replicas[r].pos.assign(_dist.size(), 0);
+        for (int i = 0; i < n; i++) {
+            replicas[r].pos[tour[i]] = i;
+        }
+        replicas[r].cost = cost;
+        replicas[r].best_tour = tour;
+        replicas[r].best_cost = cost;
+        rngs.emplace_back(0x9E3779B97F4A7C15ull * (r + 1));
+    }
+
+    // starting temperature derived from the mean positive delta of random moves on the starting tour
+    double uphill = anneal(replicas[0], _dist, _neighbors, rngs[0], 0, CALIBRATION_MOVES, false);
+    replicas[0].evaluated = 0;
+    double initial_temperature = std::max(uphill / CALIBRATION_MOVES, 1e-9) / std::log(2.0);
+    double final_temperature = initial_temperature * 1e-3;
+    double ladder_ratio = num_replicas > 1 ? std::pow(LADDER_SPAN, 1.0 / (num_replicas - 1)) : 1;
+
+    // replicas 1.. run on long-lived threads, the calling thread runs replica 0 and does the exchanges between rounds
+    // while the others wait at the barrier
+    RoundBarrier barrier(num_replicas);
+    double base_temperature = initial_temperature;
+    bool running = true;
+    auto worker = [&](unsigned int r) {
+        while (true) {
+            barrier.wait(); // round start, base_temperature and running are set
+            if (!running) {
+                return;
+            }
+            {
+                TRACE_SPAN("replica", r);
+                anneal(replicas[r], _dist, _neighbors, rngs[r], base_temperature * std::pow(ladder_ratio, r), MOVES_PER_ROUND, true);
+            }
+            barrier.wait(); // round end
+        }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned int r = 1; r < num_replicas; r++) {
+        threads.emplace_back(worker, r);
+    }
+
+    unsigned int round = 0;
+    double progress;
+    while ((progress = elapsed() / time_limit) < 1 && (control == nullptr || !control->shouldStop())) {
+        base_temperature = initial_temperature * std::pow(final_temperature / initial_temperature, progress);
+
+        barrier.wait();
+        {
+            TRACE_SPAN("replica", 0);
+            anneal(replicas[0], _dist, _neighbors, rngs[0], base_temperature, MOVES_PER_ROUND, true);
+        }
+        barrier.wait();
+
+        for (Replica &r: replicas) {
+            // resync with the exact cost so floating point error does not build up
+            r.cost = _dist.tourCost(r.tour);
+            if (r.cost < r.best_cost) {
+                r.best_cost = r.cost;
+                r.best_tour = r.tour;
+            }
+            if (control != nullptr) {
+                control->reportCost(r.best_cost);
+            }
+        }
+        if (control != nullptr) {
+            control->addWork((uint64_t) num_replicas * MOVES_PER_ROUND);
+        }
+
+        // replica exchange between neighboring temperatures, alternating even and odd pairs
+        for (unsigned int r = round % 2; r + 1 < num_replicas; r += 2) {
+            double cold = base_temperature * std::pow(ladder_ratio, r);
+            double hot = cold * ladder_ratio;
+            double exponent = (replicas[r].cost - replicas[r + 1].cost) * (1 / cold - 1 / hot);
+            if (exponent >= 0 || rngs[0].uniform() < std::exp(exponent)) {
+                std::swap(replicas[r].tour, replicas[r + 1].tour);
+                std::swap(replicas[r].pos, replicas[r + 1].pos);
+                std::swap(replicas[r].cost, replicas[r + 1].cost);
+            }
+        }
+        round++;
+    }
+
+    running = false;
+    barrier.wait(); // releases the workers from the round start, they see running and return
+    for (auto &thread: threads) {
+        thread.join();
+    }
+
+    _elapsed = elapsed();
+    double best_cost = cost;
+    for (Replica &r: replicas) {
+        _moves_evaluated += r.evaluated;
+        _moves_accepted += r.accepted;
+        if (r.best_cost < best_cost) {
+            best_cost = r.best_cost;
+            tour = r.best_tour;
+        }
+    }
+
+    // the final temperature still accepts some uphill moves, finish in a local optimum
+    localsearch::twoOpt(tour, _dist, _neighbors, {}, control);
+    if (control != nullptr) {
+        control->flush();
+    }
+    return _dist.tourCost(tour);
+}
+
+template<class Matrix>
+unsigned long long BasicSimulatedAnnealing<Matrix>::getMovesEvaluated() const {
+    return _moves_evaluated;
+}
+
+template<class Matrix>
+unsigned long long BasicSimulatedAnnealing<Matrix>::getMovesAccepted() const {
+    return _moves_accepted;
+}
+
+template<class Matrix>
+double BasicSimulatedAnnealing<Matrix>::getMovesPerSecond() const {
+    return _elapsed > 0 ? _moves_evaluated / _elapsed : 0;
+}
+
+template class BasicSimulatedAnnealing<DistanceMatrix>;
+template class BasicSimulatedAnnealing<TiledDistanceMatrix>;
@@ -0,0 +1,79 @@
+#include "SolveControl.h"
+
+#include <algorithm>
+#include <limits>
+
+SolveControl::SolveControl()
+    : _deadline(clock::time_point::max()), _best_cost(std::numeric_limits<double>::infinity()) {}
+
+SolveControl::SolveControl(double time_limit): SolveControl() {
+    if (time_limit > 0) {
+        _deadline = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(time_limit));
+    }
+}
+
+void SolveControl::cancel() {
+    _stop.store(true, std::memory_order_relaxed);
+}
+
+bool SolveControl::shouldStop() {
+    if (_stop.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    if (_deadline != clock::time_point::max() && clock::now() >= _deadline) {
+        _stop.store(true, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void SolveControl::flush() {
+    PollState &state = pollState();
+    if (state.owner == this) {
+        addWork(state.pending);
+        state.owner = nullptr;
+        state.countdown = 0;
+        state.pending = 0;
+    }
+}
+
+bool SolveControl::isStopped() const {
+    return _stop.load(std::memory_order_relaxed);
+}
+
+double SolveControl::getRemaining(double limit) const {
+    if (isStopped()) {
+        return 0;
+    }
+    if (_deadline == clock::time_point::max()) {
+        return limit;
+    }
+    return std::clamp(std::chrono::duration<double>(_deadline - clock::now()).count(), 0.0, limit);
+}
+
+void SolveControl::reportCost(double cost) {
+    double best = _best_cost.load(std::memory_order_relaxed);
+    while (cost < best && !_best_cost.compare_exchange_weak(best, cost, std::memory_order_relaxed)) {}
+}
+
+void SolveControl::addWork(uint64_t amount) {
+    if (amount != 0) {
+        _work.fetch_add(amount, std::memory_order_relaxed);
+    }
+}
+
+double SolveControl::getBestCost() const {
+    return _best_cost.load(std::memory_order_relaxed);
+}
+
+uint64_t SolveControl::getWork() const {
+    return _work.load(std::memory_order_relaxed);
+}
+
+void SolveControl::setOptimal(bool optimal) {
+    _optimal.store(optimal, std::memory_order_relaxed);
+}
+
+bool SolveControl::isOptimal() const {
+    return _optimal.load(std::memory_order_relaxed);
+}
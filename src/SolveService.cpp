@@ -0,0 +1,237 @@
+#include "SolveService.h"
+#include "LocalSearch.h"
+#include "Reordering.h"
+#include "SimulatedAnnealing.h"
+#include "SolveControl.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+// number of candidate neighbors per vertex in the 2-opt moves
+static const unsigned int NUM_NEIGHBORS = 10;
+
+static const char* ALGORITHMS[] = {"nearest-neighbor", "ils", "annealing", "bruteforce"};
+
+// Pack the graph in locality order
+static CompactGraph localityGraph(const Graph &graph) {
+    CompactGraph compact(graph);
+    return compact.permute(reordering::localityOrder(compact));
+}
+
+// Distances between the given vertexes of the graph: edge weights, or haversine distances for the missing edges of
+// graphs with coordinates
+static DistanceMatrix subsetMatrix(const CompactGraph &graph, const std::vector<int> &members,
+                                   const std::vector<int> &local_of) {
+    std::size_t m = members.size();
+    DistanceMatrix dist(m);
+    for (std::size_t a = 0; a < m; a++) {
+        for (int e = graph.edgesBegin(members[a]); e < graph.edgesEnd(members[a]); e++) {
+            int b = local_of[graph.getTarget(e)];
+            if (b != -1) {
+                dist.set(a, b, graph.getWeight(e));
+            }
+        }
+    }
+
+    if (graph.hasCoordinates()) {
+        for (std::size_t a = 0; a < m; a++) {
+            for (std::size_t b = a + 1; b < m; b++) {
+                if (dist(a, b) == std::numeric_limits<double>::infinity()) {
+                    double d = graph.haversine(members[a], members[b]);
+                    dist.set(a, b, d);
+                    dist.set(b, a, d);
+                }
+            }
+        }
+    }
+    return dist;
+}
+
+// Extend the path in every way cheaper than the best tour, which starts as the tour given
+static void branchAndBound(const DistanceMatrix &dist, std::vector<int> &path, std::vector<bool> &used, double cost,
+                           double &best_cost, std::vector<int> &best_tour, SolveControl &control) {
+    if (control.poll(1)) {
+        return;
+    }
+
+    int n = (int) dist.size();
+    int last = path.back();
+    if ((int) path.size() == n) {
+        cost += dist(last, path.front());
+        if (cost < best_cost) {
+            best_cost = cost;
+            best_tour = path;
+            control.reportCost(cost);
+        }
+        return;
+    }
+
+    for (int v = 0; v < n; v++) {
+        if (!used[v] && cost + dist(last, v) < best_cost) {
+            used[v] = true;
+            path.push_back(v);
+            branchAndBound(dist, path, used, cost + dist(last, v), best_cost, best_tour, control);
+            path.pop_back();
+            used[v] = false;
+        }
+    }
+}
+
+SolveService::SolveService(const Graph &graph, unsigned int num_threads)
+    : _graph(localityGraph(graph)), _matrix_limit(graph.getDenseMatrixLimit()), _pool(num_threads) {
+    std::vector<int> ids(_graph.getNumVertex());
+    for (int v = 0; v < _graph.getNumVertex(); v++) {
+        ids[v] = _graph.getOriginalId(v);
+    }
+    _index_of = reordering::inverse(ids);
+}
+
+bool SolveService::supports(const std::string &algorithm) {
+    for (const char* name: ALGORITHMS) {
+        if (algorithm == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+SolveService::Result SolveService::solve(const Request &request) {
+    TRACE_SPAN("service-request");
+    using clock = std::chrono::steady_clock;
+    auto start_time = clock::now();
+
+    Result result;
+    int n = _graph.getNumVertex();
+    if (!supports(request.algorithm)) {
+        result.error = "unknown algorithm " + request.algorithm;
+        return result;
+    }
+    auto valid = [n](int id) { return id >= 0 && id < n; };
+    if (!valid(request.start)) {
+        result.error = "unknown start vertex " + std::to_string(request.start);
+        return result;
+    }
+
+    // matrix of the request, its index i is the vertex members[i] of the graph (or i itself for every vertex)
+    const DistanceMatrix* dist;
+    const std::vector<std::vector<int>>* neighbors;
+    std::vector<int> members;
+    DistanceMatrix own_matrix(0);
+    std::vector<std::vector<int>> own_neighbors;
+    int start;
+    bool needs_neighbors = request.algorithm == "ils" || request.algorithm == "annealing"
+                           || (request.algorithm == "nearest-neighbor" && request.two_opt);
+    auto fits = [this](std::size_t m) { return m * m * sizeof(double) <= _matrix_limit; };
+    if (request.vertexes.empty()) {
+        if (!fits(n)) {
+            result.error = "distance matrix of the graph exceeds the dense matrix limit";
+            return result;
+        }
+        std::call_once(_full_once, [this]() {
+            _full_matrix = std::make_unique<DistanceMatrix>(_graph);
+            _full_neighbors = localsearch::nearestNeighbors(*_full_matrix, NUM_NEIGHBORS);
+        });
+        dist = _full_matrix.get();
+        neighbors = &_full_neighbors;
+        start = _index_of[request.start];
+    } else {
+        std::vector<int> local_of(n, -1);
+        auto add = [&](int id) {
+            int v = _index_of[id];
+            if (local_of[v] == -1) {
+                local_of[v] = (int) members.size();
+                members.push_back(v);
+            }
+        };
+        add(request.start);
+        for (int id: request.vertexes) {
+            if (!valid(id)) {
+                result.error = "unknown vertex " + std::to_string(id);
+                return result;
+            }
+            add(id);
+        }
+        if (!fits(members.size())) {
+            result.error = "distance matrix of the subset exceeds the dense matrix limit";
+            return result;
+        }
+
+        own_matrix = subsetMatrix(_graph, members, local_of);
+        if (needs_neighbors) {
+            own_neighbors = localsearch::nearestNeighbors(own_matrix, NUM_NEIGHBORS);
+        }
+        dist = &own_matrix;
+        neighbors = &own_neighbors;
+        start = 0;
+    }
+
+    SolveControl control(request.deadline);
+    std::vector<int> tour = localsearch::nearestNeighborTour(*dist, start);
+    if (needs_neighbors) {
+        localsearch::twoOpt(tour, *dist, *neighbors, {}, &control);
+    }
+
+    int m = (int) dist->size();
+    if (request.algorithm == "ils" && m >= 8) {
+        localsearch::Random rng(request.seed);
+        auto deadline = clock::now() + std::chrono::duration_cast<clock::duration>(
+                std::chrono::duration<double>(control.getRemaining(request.time_limit)));
+        double cost = dist->tourCost(tour);
+        std::vector<int> candidate, endpoints;
+        while (!control.shouldStop() && clock::now() < deadline) {
+            candidate = tour;
+            double candidate_cost = cost + localsearch::doubleBridge(candidate, *dist, rng, endpoints);
+            candidate_cost += localsearch::twoOpt(candidate, *dist, *neighbors, endpoints, &control);
+            if (candidate_cost < cost - 1e-9) {
+                tour.swap(candidate);
+                cost = candidate_cost;
+            }
+        }
+    } else if (request.algorithm == "annealing") {
+        SimulatedAnnealing annealing(*dist, *neighbors);
+        annealing.run(tour, request.time_limit, 1, &control);
+    } else if (request.algorithm == "bruteforce") {
+        // the nearest neighbor tour is the first bound, and the answer if stopped before anything better
+        double best_cost = dist->tourCost(tour);
+        std::vector<int> path = {start};
+        std::vector<bool> used(m, false);
+        used[start] = true;
+        branchAndBound(*dist, path, used, 0, best_cost, tour, control);
+        // no finite tour means the vertexes are not connected, there is nothing to prove optimal
+        control.setOptimal(!control.isStopped() && best_cost != std::numeric_limits<double>::infinity());
+    }
+
+    control.flush();
+
+    std::rotate(tour.begin(), std::find(tour.begin(), tour.end(), start), tour.end());
+    result.cost = dist->tourCost(tour);
+    result.tour.reserve(tour.size() + 1);
+    for (int v: tour) {
+        result.tour.push_back(_graph.getOriginalId(members.empty() ? v : members[v]));
+    }
+    result.tour.push_back(request.start);
+
+    result.optimal = control.isOptimal();
+    result.stopped = control.isStopped();
+    result.solve_time = std::chrono::duration<double>(clock::now() - start_time).count();
+    return result;
+}
+
+std::future<SolveService::Result> SolveService::submit(const Request &request) {
+    return _pool.submit([this, request]() { return solve(request); });
+}
+
+std::vector<std::future<SolveService::Result>> SolveService::submitAll(const std::vector<Request> &requests) {
+    std::vector<std::future<Result>> results;
+    results.reserve(requests.size());
+    for (const Request &request: requests) {
+        results.push_back(submit(request));
+    }
+    return results;
+}
+
+unsigned int SolveService::getNumWorkers() const {
+    return _pool.size();
+}
@@ -0,0 +1,212 @@
+#include "TiledDistanceMatrix.h"
+#include "CompactGraph.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FEUP_DA2_HAS_MMAP
+#endif
+
+static const char MAGIC[8] = {'F', 'D', 'A', '2', 'T', 'M', '\0', '\0'};
+static const uint32_t FORMAT_VERSION = 1;
+
+// The header is padded to a page so every tile starts at a page boundary
+static const std::size_t HEADER_SIZE = 4096;
+
+// Smallest tile side, 32 * 32 floats fill one 4 KB page
+static const unsigned int MIN_TILE_SHIFT = 5;
+
+TiledDistanceMatrix::~TiledDistanceMatrix() {
+    close();
+}
+
+bool TiledDistanceMatrix::create(const std::string &path, const CompactGraph &graph, unsigned int tile_size) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    unsigned int shift = MIN_TILE_SHIFT;
+    while ((1u << shift) < tile_size) {
+        shift++;
+    }
+    std::size_t side = (std::size_t) 1 << shift;
+    uint64_t size = graph.getNumVertex();
+    std::size_t tiles_per_side = (size + side - 1) / side;
+
+    char header[HEADER_SIZE] = {};
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    std::memcpy(header + 8, &FORMAT_VERSION, sizeof(FORMAT_VERSION));
+    std::memcpy(header + 12, &shift, sizeof(shift));
+    std::memcpy(header + 16, &size, sizeof(size));
+    file.write(header, HEADER_SIZE);
+
+    // one row of tiles, from the diagonal to the last column
+    std::vector<float> rows;
+    for (std::size_t tile_row = 0; tile_row < tiles_per_side; tile_row++) {
+        std::size_t first_row = tile_row * side;
+        std::size_t first_col = first_row;
+        std::size_t width = (tiles_per_side - tile_row) * side;
+        rows.assign(side * width, std::numeric_limits<float>::infinity());
+
+        for (std::size_t r = 0; r < side && first_row + r < size; r++) {
+            int u = (int) (first_row + r);
+            float* row = &rows[r * width];
+            if (graph.hasCoordinates()) {
+                for (std::size_t c = u; c < size; c++) {
+                    row[c - first_col] = (float) graph.haversine(u, (int) c);
+                }
+            }
+            for (int e = graph.edgesBegin(u); e < graph.edgesEnd(u); e++) {
+                std::size_t v = graph.getTarget(e);
+                if (v >= first_col) {
+                    row[v - first_col] = (float) graph.getWeight(e);
+                }
+            }
+            row[u - first_col] = 0;
+        }
+
+        for (std::size_t tile_col = tile_row; tile_col < tiles_per_side; tile_col++) {
+            for (std::size_t r = 0; r < side; r++) {
+                file.write(reinterpret_cast<const char *>(&rows[r * width + (tile_col - tile_row) * side]),
+                           side * sizeof(float));
+            }
+        }
+    }
+
+    return (bool) file;
+}
+
+// Check the header of a file written by create and the file length it implies
+static bool readHeader(const char* header, std::size_t file_size, unsigned int &shift, uint64_t &size) {
+    if (file_size < HEADER_SIZE || std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0) {
+        return false;
+    }
+
+    uint32_t version;
+    std::memcpy(&version, header + 8, sizeof(version));
+    std::memcpy(&shift, header + 12, sizeof(shift));
+    std::memcpy(&size, header + 16, sizeof(size));
+    if (version != FORMAT_VERSION || shift < MIN_TILE_SHIFT || shift > 16) {
+        return false;
+    }
+
+    std::size_t side = (std::size_t) 1 << shift;
+    std::size_t tiles_per_side = (size + side - 1) / side;
+    std::size_t num_tiles = tiles_per_side * (tiles_per_side + 1) / 2;
+    return file_size == HEADER_SIZE + num_tiles * side * side * sizeof(float);
+}
+
+bool TiledDistanceMatrix::open(const std::string &path, std::size_t cache_tiles) {
+    close();
+
+    unsigned int shift;
+    uint64_t size;
+#ifdef FEUP_DA2_HAS_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    char header[HEADER_SIZE];
+    if (fstat(fd, &info) != 0 || (std::size_t) info.st_size < HEADER_SIZE
+        || pread(fd, header, HEADER_SIZE, 0) != (ssize_t) HEADER_SIZE
+        || !readHeader(header, info.st_size, shift, size)) {
+        ::close(fd);
+        return false;
+    }
+
+    void* map = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // the mapping keeps the file open
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    // tiles are visited along the tour, not sequentially
+    madvise(map, info.st_size, MADV_RANDOM);
+    std::size_t length = info.st_size;
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::size_t length = file.tellg();
+    char header[HEADER_SIZE];
+    file.seekg(0);
+    if (length < HEADER_SIZE || !file.read(header, HEADER_SIZE) || !readHeader(header, length, shift, size)) {
+        return false;
+    }
+
+    char* map = new char[length];
+    file.seekg(0);
+    if (!file.read(map, length)) {
+        delete[] map;
+        return false;
+    }
+#endif
+
+    _map = map;
+    _map_length = length;
+    _tiles = reinterpret_cast<const float *>(static_cast<const char *>(_map) + HEADER_SIZE);
+    _size = size;
+    _tile_shift = shift;
+    std::size_t side = (std::size_t) 1 << shift;
+    _tiles_per_side = (size + side - 1) / side;
+    _cache_slots = std::max<std::size_t>(1, cache_tiles);
+    _cache.reset(new std::atomic<int64_t>[_cache_slots]);
+    for (std::size_t slot = 0; slot < _cache_slots; slot++) {
+        _cache[slot].store(-1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+void TiledDistanceMatrix::close() {
+    if (_map != nullptr) {
+#ifdef FEUP_DA2_HAS_MMAP
+        munmap(_map, _map_length);
+#else
+        delete[] static_cast<char *>(_map);
+#endif
+    }
+    _map = nullptr;
+    _map_length = 0;
+    _tiles = nullptr;
+    _size = 0;
+    _tiles_per_side = 0;
+    _cache.reset();
+    _cache_slots = 0;
+}
+
+void TiledDistanceMatrix::admit(std::size_t tile, std::size_t slot) const {
+    int64_t previous = _cache[slot].exchange((int64_t) tile, std::memory_order_relaxed);
+#ifdef FEUP_DA2_HAS_MMAP
+    std::size_t tile_bytes = sizeof(float) << (2 * _tile_shift);
+    auto base = const_cast<char *>(reinterpret_cast<const char *>(_tiles));
+    if (previous >= 0 && previous != (int64_t) tile) {
+        // the pages are clean, a later access to the tile reads them back from the page cache or the file
+        madvise(base + previous * tile_bytes, tile_bytes, MADV_DONTNEED);
+    }
+    madvise(base + tile * tile_bytes, tile_bytes, MADV_WILLNEED);
+#else
+    (void) previous; // the whole matrix is in memory
+#endif
+}
+
+std::size_t TiledDistanceMatrix::size() const {
+    return _size;
+}
+
+double TiledDistanceMatrix::tourCost(const std::vector<int> &tour) const {
+    double cost = 0;
+    for (std::size_t i = 0; i < tour.size(); i++) {
+        cost += (*this)(tour[i], tour[(i + 1) % tour.size()]);
+    }
+    return cost;
+}
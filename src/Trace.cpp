@@ -0,0 +1,148 @@
+#include "Trace.h"
+#include "Allocations.h"
+#include "Instrumentation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <vector>
+
+struct Event {
+    const char* name;
+    int64_t index;
+    int thread;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point end;
+};
+
+// Recorded spans, behind one mutex (spans are coarse, so appending is rare)
+struct Recorder {
+    std::atomic<bool> recording{false};
+    std::mutex mutex;
+    std::vector<Event> events;
+    std::chrono::steady_clock::time_point origin;
+    std::set<int> free_threads;
+    int num_threads = 0;
+};
+
+// Never destroyed, so threads finishing during static destruction can still end their spans
+static Recorder &recorder() {
+    static Recorder* instance = new Recorder();
+    return *instance;
+}
+
+// Timeline row of a thread: the lowest row not used by a live thread, so short-lived threads (e.g. the replicas of
+// each annealing round) reuse the rows of the ones that finished instead of adding a row each
+struct ThreadRow {
+    int id;
+
+    ThreadRow() {
+        Recorder &r = recorder();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        if (r.free_threads.empty()) {
+            id = r.num_threads++;
+        } else {
+            id = *r.free_threads.begin();
+            r.free_threads.erase(r.free_threads.begin());
+        }
+    }
+
+    ~ThreadRow() {
+        Recorder &r = recorder();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.free_threads.insert(id);
+    }
+};
+
+static int threadId() {
+    thread_local ThreadRow row;
+    return row.id;
+}
+
+void trace::start() {
+    Recorder &r = recorder();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.events.clear();
+    r.origin = std::chrono::steady_clock::now();
+    r.recording = true;
+}
+
+void trace::stop() {
+    recorder().recording = false;
+}
+
+bool trace::isRecording() {
+    return recorder().recording.load(std::memory_order_relaxed);
+}
+
+trace::Span::Span(const char* name, int64_t index): _name(name), _index(index), _recording(isRecording()), _parent_phase(0) {
+    if (allocation::ENABLED) {
+        _parent_phase = allocation::enterPhase(name);
+    }
+    if (_recording) {
+        threadId(); // takes the row when the span begins, so overlapping spans never share one
+    }
+    if (_recording || instrument::ENABLED) {
+        _start = std::chrono::steady_clock::now();
+    }
+}
+
+trace::Span::~Span() {
+    if (allocation::ENABLED) {
+        allocation::leavePhase(_parent_phase);
+    }
+    if (!_recording && !instrument::ENABLED) {
+        return;
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    if (instrument::ENABLED) {
+        instrument::addPhase(_name, std::chrono::duration<double>(end - _start).count());
+    }
+    if (!_recording) {
+        return;
+    }
+
+    int thread = threadId();
+    Recorder &r = recorder();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.events.push_back({_name, _index, thread, _start, end});
+}
+
+bool trace::write(const std::string &path) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        return false;
+    }
+
+    Recorder &r = recorder();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto micros = [&](std::chrono::steady_clock::time_point t) {
+        return std::chrono::duration<double, std::micro>(t - r.origin).count();
+    };
+
+    int num_threads = 0;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    out.precision(3);
+    out << std::fixed;
+    for (std::size_t i = 0; i < r.events.size(); i++) {
+        const Event &e = r.events[i];
+        num_threads = std::max(num_threads, e.thread + 1);
+        out << (i > 0 ? ",\n" : "\n") << "{\"name\":\"" << e.name << "\",\"cat\":\"solver\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+            << e.thread << ",\"ts\":" << micros(e.start) << ",\"dur\":" << micros(e.end) - micros(e.start);
+        if (e.index >= 0) {
+            out << ",\"args\":{\"index\":" << e.index << '}';
+        }
+        out << '}';
+    }
+
+    for (int t = 0; t < num_threads; t++) {
+        out << (r.events.empty() ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t
+            << ",\"args\":{\"name\":\"thread " << t << "\"}}";
+    }
+    out << "\n]}\n";
+
+    return out.good();
+}
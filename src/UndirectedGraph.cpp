@@ -0,0 +1,241 @@
+#include "UndirectedGraph.h"
+#include "Utils.h"
+#include "VertexEdge.h"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+
+void UndirectedGraph::buildIncidence(int num_vertex) {
+    _offsets.assign(num_vertex + 1, 0);
+    for (int end: _ends) {
+        _offsets[end + 1]++;
+    }
+    for (int v = 0; v < num_vertex; v++) {
+        _offsets[v + 1] += _offsets[v];
+    }
+
+    _incidence.resize(_ends.size());
+    std::vector<int> next(_offsets.begin(), _offsets.end() - 1);
+    for (std::size_t i = 0; i < _ends.size(); i++) {
+        _incidence[next[_ends[i]]++] = (int) (i / 2);
+    }
+}
+
+bool UndirectedGraph::load(const std::string &edges_file, const std::string &nodes_file) {
+    _ends.clear();
+    _weights.clear();
+    _offsets.clear();
+    _incidence.clear();
+    _longitudes.clear();
+    _latitudes.clear();
+
+    std::string line;
+    int num_vertex = 0;
+
+    try {
+        if (!nodes_file.empty()) {
+            std::ifstream node(nodes_file);
+            if (!node.is_open()) {
+                return false;
+            }
+
+            // discard first line
+            getline(node, line);
+
+            while (getline(node, line)) {
+                if (utils::isBlank(line)) {
+                    continue;
+                }
+                std::stringstream ss(line);
+                std::string id_str, long_str, lat_str;
+
+                getline(ss, id_str, ',');
+                getline(ss, long_str, ',');
+                getline(ss, lat_str);
+
+                int id = std::stoi(id_str);
+                if (id < 0) {
+                    return false;
+                }
+                if (id >= (int) _longitudes.size()) {
+                    _longitudes.resize(id + 1);
+                    _latitudes.resize(id + 1);
+                }
+                _longitudes[id] = std::stod(long_str);
+                _latitudes[id] = std::stod(lat_str);
+            }
+            num_vertex = (int) _longitudes.size();
+        }
+
+        std::ifstream edge(edges_file);
+        if (!edge.is_open()) {
+            return false;
+        }
+
+        // discard first line
+        getline(edge, line);
+
+        while (getline(edge, line)) {
+            if (utils::isBlank(line)) {
+                continue;
+            }
+            std::stringstream ss(line);
+            std::string origin_str, dest_str, distance;
+
+            getline(ss, origin_str, ',');
+            getline(ss, dest_str, ',');
+            getline(ss, distance);
+
+            int origin = std::stoi(origin_str);
+            int dest = std::stoi(dest_str);
+            if (origin < 0 || dest < 0) {
+                return false;
+            }
+            num_vertex = std::max(num_vertex, std::max(origin, dest) + 1);
+
+            _ends.push_back(origin);
+            _ends.push_back(dest);
+            _weights.push_back(std::stod(distance));
+        }
+    } catch (const std::invalid_argument &) {
+        return false; // a field is not a number
+    } catch (const std::out_of_range &) {
+        return false;
+    }
+
+    if (!_longitudes.empty()) {
+        _longitudes.resize(num_vertex);
+        _latitudes.resize(num_vertex);
+    }
+
+    _ends.shrink_to_fit();
+    _weights.shrink_to_fit();
+    buildIncidence(num_vertex);
+    return true;
+}
+
+int UndirectedGraph::getNumVertex() const {
+    return _offsets.empty() ? 0 : (int) _offsets.size() - 1;
+}
+
+std::size_t UndirectedGraph::getNumEdges() const {
+    return _weights.size();
+}
+
+bool UndirectedGraph::hasCoordinates() const {
+    return !_longitudes.empty();
+}
+
+double UndirectedGraph::haversine(int u, int v) const {
+    return LongLatVertex::haversine(_longitudes[u], _latitudes[u], _longitudes[v], _latitudes[v]);
+}
+
+double UndirectedGraph::findDistance(int u, int v) const {
+    if (incidentEnd(u) - incidentBegin(u) > incidentEnd(v) - incidentBegin(v)) {
+        std::swap(u, v);
+    }
+
+    for (int i = incidentBegin(u); i < incidentEnd(u); i++) {
+        int e = _incidence[i];
+        if (getOther(e, u) == v) {
+            return _weights[e];
+        }
+    }
+
+    if (hasCoordinates()) {
+        return haversine(u, v);
+    }
+    return std::numeric_limits<double>::infinity();
+}
+
+double UndirectedGraph::prim(int root, std::vector<int> &parent, std::vector<int> &order) const {
+    using Entry = std::pair<double, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> pq;
+
+    int n = getNumVertex();
+    std::vector<double> key(n, std::numeric_limits<double>::infinity());
+    std::vector<bool> in_tree(n, false);
+    parent.assign(n, -1);
+    order.clear();
+
+    double cost = 0;
+    key[root] = 0;
+    pq.push({0, root});
+    while (!pq.empty()) {
+        auto [k, u] = pq.top();
+        pq.pop();
+        if (in_tree[u]) {
+            continue; // outdated entry
+        }
+        in_tree[u] = true;
+        order.push_back(u);
+        cost += k;
+
+        for (int i = incidentBegin(u); i < incidentEnd(u); i++) {
+            int e = _incidence[i];
+            int v = getOther(e, u);
+            if (!in_tree[v] && _weights[e] < key[v]) {
+                key[v] = _weights[e];
+                parent[v] = u;
+                pq.push({key[v], v});
+            }
+        }
+    }
+
+    return cost;
+}
+
+double UndirectedGraph::triangularApproximation(std::vector<int> &tour) const {
+    tour.clear();
+    int n = getNumVertex();
+    if (n == 0) {
+        return 0;
+    }
+
+    std::vector<int> parent, order;
+    prim(0, parent, order);
+
+    // children lists of the tree in CSR layout
+    std::vector<int> child_offsets(n + 1, 0);
+    for (int v = 0; v < n; v++) {
+        if (parent[v] != -1) {
+            child_offsets[parent[v] + 1]++;
+        }
+    }
+    for (int v = 0; v < n; v++) {
+        child_offsets[v + 1] += child_offsets[v];
+    }
+    std::vector<int> children(child_offsets[n]);
+    std::vector<int> next(child_offsets.begin(), child_offsets.end() - 1);
+    for (int v: order) {
+        if (parent[v] != -1) {
+            children[next[parent[v]]++] = v;
+        }
+    }
+
+    std::vector<int> stack = {0};
+    while (!stack.empty()) {
+        int u = stack.back();
+        stack.pop_back();
+        tour.push_back(u);
+        for (int i = child_offsets[u + 1] - 1; i >= child_offsets[u]; i--) {
+            stack.push_back(children[i]);
+        }
+    }
+
+    double cost = 0;
+    for (std::size_t i = 0; i < tour.size(); i++) {
+        cost += findDistance(tour[i], tour[(i + 1) % tour.size()]);
+    }
+    return cost;
+}
+
+std::size_t UndirectedGraph::memoryUsage() const {
+    return (_ends.size() + _offsets.size() + _incidence.size()) * sizeof(int) + _weights.size() * sizeof(double)
+         + (_longitudes.size() + _latitudes.size()) * sizeof(double);
+}
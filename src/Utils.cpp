@@ -1,5 +1,7 @@
 #include "Utils.h"
 
+#include <algorithm>
+#include <cctype>
 #include <iostream>
 #include <limits>
 
@@ -18,3 +20,7 @@ void utils::waitEnter() {
     while(std::cin.get() != '\n');
     utils::clearScreen();
 }
+
+bool utils::isBlank(const std::string &line) {
+    return std::all_of(line.begin(), line.end(), [](unsigned char c) { return std::isspace(c); });
+}
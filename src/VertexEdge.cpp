@@ -1,11 +1,20 @@
 #include "VertexEdge.h"
+#include "Instrumentation.h"
 
+#include <algorithm>
 #include <cmath>
 
 /*===== Vertex =====*/
 
 Vertex::Vertex(int id): _id(id) {}
 
+VertexCold& Vertex::cold() {
+    if (_cold == nullptr) {
+        _cold = std::make_unique<VertexCold>();
+    }
+    return *_cold;
+}
+
 int Vertex::getId() const {
     return this->_id;
 }
@@ -15,10 +24,16 @@ std::vector<Edge *> Vertex::getAdj() const {
 }
 
 Edge* Vertex::getEdge(int dest_id) const {
-    for (Edge* edge : _adj) {
-        if (edge->getDest()->getId() == dest_id) {
-            return edge;
-        }
+    INSTRUMENT_COUNT(GET_EDGE_CALLS);
+    if (!_adj_sorted) {
+        INSTRUMENT_ADD(GET_EDGE_PROBES, _adj_ids.size());
+        auto it = std::find(_adj_ids.begin(), _adj_ids.end(), dest_id);
+        return it != _adj_ids.end() ? _adj[it - _adj_ids.begin()] : nullptr;
+    }
+    INSTRUMENT_ADD(GET_EDGE_PROBES, instrument::binarySearchProbes(_adj_ids.size()));
+    auto it = std::lower_bound(_adj_ids.begin(), _adj_ids.end(), dest_id);
+    if (it != _adj_ids.end() && *it == dest_id) {
+        return _adj[it - _adj_ids.begin()];
     }
     return nullptr;
 }
@@ -28,11 +43,11 @@ bool Vertex::isVisited() const {
 }
 
 bool Vertex::isProcessing() const {
-    return this->_processing;
+    return this->_cold != nullptr && this->_cold->processing;
 }
 
 unsigned int Vertex::getIndegree() const {
-    return this->_indegree;
+    return this->_cold != nullptr ? this->_cold->indegree : 0;
 }
 
 Edge* Vertex::getPath() const {
@@ -40,7 +55,7 @@ Edge* Vertex::getPath() const {
 }
 
 std::vector<Edge *> Vertex::getIncomming() const {
-    return this->_incomming;
+    return this->_cold != nullptr ? this->_cold->incomming : std::vector<Edge *>();
 }
 
 double Vertex::getDistance() const{
@@ -56,11 +71,11 @@ void Vertex::setVisited(bool visited) {
 }
 
 void Vertex::setProcessing(bool processing) {
-    this->_processing = processing;
+    cold().processing = processing;
 }
 
 void Vertex::setIndegree(unsigned int indegree) {
-    this->_indegree = indegree;
+    cold().indegree = indegree;
 }
 
 void Vertex::setDistance(double distance) {
@@ -73,35 +88,77 @@ void Vertex::setPath(Edge* path) {
 
 Edge* Vertex::addEdge(Vertex* dest, double weight) {
     auto newEdge = new Edge(this, dest, weight);
+    if (!_adj_ids.empty() && _adj_ids.back() > dest->getId()) {
+        _adj_sorted = false;
+    }
     _adj.push_back(newEdge);
-    dest->_incomming.push_back(newEdge);
+    _adj_ids.push_back(dest->getId());
     return newEdge;
 }
 
+void Vertex::sortAdjacency() {
+    if (_adj_sorted) {
+        return;
+    }
+
+    // stable, so parallel edges keep their insertion order
+    std::stable_sort(_adj.begin(), _adj.end(), [](Edge* a, Edge* b) {
+        return a->getDest()->getId() < b->getDest()->getId();
+    });
+    for (std::size_t i = 0; i < _adj.size(); i++) {
+        _adj_ids[i] = _adj[i]->getDest()->getId();
+    }
+    _adj_sorted = true;
+}
+
+void Vertex::addIncomming(Edge* edge) {
+    cold().incomming.push_back(edge);
+}
+
+void Vertex::clearIncomming() {
+    if (this->_cold != nullptr) {
+        this->_cold->incomming.clear();
+    }
+}
+
 bool Vertex::removeEdge(int destId) {
-    bool edgeRemoved = false;
-    for (auto it = _adj.begin(); it != _adj.end();) {
-        Edge* edge = *it;
-        Vertex* dest = edge->getDest();
-        if (dest->getId() == destId) {
-            it = _adj.erase(it);
-
-            for (auto it2 = dest->_incomming.begin(); it2 != dest->_incomming.end();) {
-                if ((*it2)->getOrigin()->getId() == _id) {
-                    it2 = dest->_incomming.erase(it2);
-                } else {
-                    it2++;
-                }
-            }
-
-            delete edge;
-            edgeRemoved = true;
+    // compacts both lists in place, keeping the order of the remaining edges (sorted or not)
+    std::vector<Edge *> removed;
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < _adj.size(); i++) {
+        if (_adj_ids[i] == destId) {
+            removed.push_back(_adj[i]);
         } else {
-            it++;
+            _adj[kept] = _adj[i];
+            _adj_ids[kept] = _adj_ids[i];
+            kept++;
         }
     }
+    if (removed.empty()) {
+        return false;
+    }
+    _adj.resize(kept);
+    _adj_ids.resize(kept);
 
-    return edgeRemoved;
+    for (Edge* edge: removed) {
+        Vertex* dest = edge->getDest();
+        if (dest->_cold != nullptr) {
+            auto &incomming = dest->_cold->incomming;
+            incomming.erase(std::remove(incomming.begin(), incomming.end(), edge), incomming.end());
+        }
+        // a twin set with setReverse keeps no dangling pointer, it falls back to the search
+        EdgeCold* cold = edge->findCold();
+        Edge* reverse = cold != nullptr ? cold->reverse : nullptr;
+        if (reverse != nullptr && reverse != edge && reverse->findCold() != nullptr
+            && reverse->findCold()->reverse == edge) {
+            reverse->setReverse(nullptr);
+        }
+        if (cold != nullptr) {
+            this->_cold->edges.erase(edge);
+        }
+        delete edge;
+    }
+    return true;
 }
 
 bool Vertex::operator<(Vertex & vertex) const {
@@ -116,12 +173,17 @@ double degToRad(double deg) {
 LongLatVertex::LongLatVertex(int id, double longitude, double latitude): Vertex(id), _long(longitude), _lat(latitude) {}
 
 double LongLatVertex::haversine(LongLatVertex* other) {
+    return haversine(_long, _lat, other->getLong(), other->getLat());
+}
+
+double LongLatVertex::haversine(double long1, double lat1, double long2, double lat2) {
+    INSTRUMENT_COUNT(HAVERSINE_CALLS);
     const double earth_rad = 6371.0; // aproximate value of Earth radius in metres
 
-    double dLat = degToRad(other->getLat() - _lat);
-    double dLong = degToRad(other->getLong() - _long);
+    double dLat = degToRad(lat2 - lat1);
+    double dLong = degToRad(long2 - long1);
 
-    double a = std::pow(sin(dLat / 2.0), 2) + std::pow(sin(dLong / 2.0), 2) * cos(degToRad(_lat)) * cos(degToRad(other->getLat()));
+    double a = std::pow(sin(dLat / 2.0), 2) + std::pow(sin(dLong / 2.0), 2) * cos(degToRad(lat1)) * cos(degToRad(lat2));
     double c = 2 * asin(sqrt(a));
 
     return earth_rad * c;
@@ -138,7 +200,7 @@ double LongLatVertex::getLong() {
 /*===== Edge =====*/
 
 Edge::Edge(Vertex* origin, Vertex* dest, double weight)
-    : _origin(origin), _dest(dest), _weight(weight) {}
+    : _dest(dest), _weight(weight), _origin(origin) {}
 
 Vertex* Edge::getDest() const {
     return this->_dest;
@@ -152,18 +214,37 @@ Vertex* Edge::getOrigin() const {
     return this->_origin;
 }
 
+EdgeCold* Edge::findCold() const {
+    if (this->_origin->_cold == nullptr) {
+        return nullptr;
+    }
+    auto &edges = this->_origin->_cold->edges;
+    auto it = edges.find(this);
+    return it != edges.end() ? &it->second : nullptr;
+}
+
 Edge* Edge::getReverse() const {
-    return this->_reverse;
+    EdgeCold* cold = findCold();
+    if (cold != nullptr && cold->reverse != nullptr) {
+        return cold->reverse;
+    }
+    return this->_dest->getEdge(this->_origin->getId());
 }
 
 double Edge::getFlow() const {
-    return this->_flow;
+    EdgeCold* cold = findCold();
+    return cold != nullptr ? cold->flow : 0;
 }
 
 void Edge::setReverse(Edge* reverse) {
-    this->_reverse = reverse;
+    EdgeCold* cold = findCold();
+    if (cold != nullptr) {
+        cold->reverse = reverse;
+    } else if (reverse != nullptr) {
+        this->_origin->cold().edges[this].reverse = reverse;
+    }
 }
 
 void Edge::setFlow(double flow) {
-    this->_flow = flow;
+    this->_origin->cold().edges[this].flow = flow;
 }
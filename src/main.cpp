@@ -1,8 +1,17 @@
 #include <iostream>
 
+#include "Batch.h"
 #include "Menu.h"
 
-int main() {
+int main(int argc, char *argv[]) {
+    if (argc > 1) {
+        Batch batch;
+        if (!batch.parse(argc, argv)) {
+            return 1;
+        }
+        return batch.run();
+    }
+
     Menu menu;
     menu.init();
 
@@ -0,0 +1,47 @@
+#include "Check.h"
+
+#include <iostream>
+#include <vector>
+
+struct Test {
+    const char* name;
+    void (*run)();
+};
+
+// Function local so registrars in other files never see it uninitialized
+static std::vector<Test> &registry() {
+    static std::vector<Test> tests;
+    return tests;
+}
+
+static int failed_checks = 0;
+
+check::Registrar::Registrar(const char* name, void (*run)()) {
+    registry().push_back({name, run});
+}
+
+void check::fail(const char* file, int line, const std::string &expression) {
+    std::cerr << "  " << file << ':' << line << ": CHECK(" << expression << ") failed\n";
+    failed_checks++;
+}
+
+int main(int argc, char *argv[]) {
+    std::string filter = argc > 1 ? argv[1] : "";
+
+    int run = 0, failed = 0;
+    for (const Test &test: registry()) {
+        if (std::string(test.name).find(filter) == std::string::npos) {
+            continue;
+        }
+
+        int before = failed_checks;
+        test.run();
+        bool ok = failed_checks == before;
+        std::cout << (ok ? "[ ok ] " : "[FAIL] ") << test.name << '\n';
+        run++;
+        failed += ok ? 0 : 1;
+    }
+
+    std::cout << run - failed << '/' << run << " tests passed\n";
+    return failed == 0 && run > 0 ? 0 : 1;
+}
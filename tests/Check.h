@@ -0,0 +1,57 @@
+#ifndef FEUP_DA2_CHECK_H
+#define FEUP_DA2_CHECK_H
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+/**
+ * @brief Minimal test harness: TEST_CASE registers a function, CHECK records a failure without stopping the test
+ * @details The runner (Check.cpp) runs every test whose name contains its first argument, and exits with 1 if any
+ * check failed, so each test file is just a list of TEST_CASEs over generated instances.
+ */
+namespace check {
+    /**
+     * @brief Adds a test to the list run by main (used through TEST_CASE)
+     */
+    struct Registrar {
+        Registrar(const char* name, void (*run)());
+    };
+
+    /**
+     * @brief Record a failed check of the running test
+     *
+     * @param file Source file of the check
+     * @param line Line of the check
+     * @param expression Text of the failed condition
+     */
+    void fail(const char* file, int line, const std::string &expression);
+
+    /**
+     * @brief If two values are equal up to a relative tolerance (both infinite counts as equal)
+     *
+     * @param a First value
+     * @param b Second value
+     * @param tolerance Relative tolerance
+     * @return true Values are close
+     */
+    inline bool near(double a, double b, double tolerance = 1e-9) {
+        return a == b || std::abs(a - b) <= tolerance * std::max(std::abs(a), std::abs(b));
+    }
+}
+
+#define TEST_CASE(name) \
+    static void name(); \
+    static check::Registrar name##_registrar(#name, name); \
+    static void name()
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            check::fail(__FILE__, __LINE__, #condition); \
+        } \
+    } while (false)
+
+#define CHECK_NEAR(a, b) CHECK(check::near((a), (b)))
+
+#endif // FEUP_DA2_CHECK_H
@@ -0,0 +1,66 @@
+#include "Check.h"
+#include "CompressedGraph.h"
+#include "CsvFiles.h"
+#include "Generator.h"
+#include "UndirectedGraph.h"
+
+#include <cmath>
+#include <map>
+#include <vector>
+
+// Every neighbor and weight decoded from the compressed lists must match the graph it was built from
+static void checkRoundTrip(const UndirectedGraph &graph, const CompressedGraph &compressed) {
+    CHECK(compressed.getNumVertex() == graph.getNumVertex());
+    CHECK(compressed.getNumEdges() == graph.getNumEdges());
+
+    for (int v = 0; v < graph.getNumVertex(); v++) {
+        std::multimap<int, double> expected;
+        for (int i = graph.incidentBegin(v); i < graph.incidentEnd(v); i++) {
+            int e = graph.getIncident(i);
+            expected.emplace(graph.getOther(e, v), graph.getWeight(e));
+        }
+
+        std::vector<std::pair<int, double>> decoded;
+        compressed.forEachNeighbor(v, [&](int u, double w) {
+            decoded.emplace_back(u, w);
+        });
+        CHECK(decoded.size() == expected.size());
+
+        auto it = expected.begin();
+        for (std::size_t i = 0; i < decoded.size() && it != expected.end(); i++, it++) {
+            CHECK(decoded[i].first == it->first);
+            CHECK(std::abs(decoded[i].second - it->second) <= compressed.getMaxError() + 1e-9);
+        }
+    }
+}
+
+// Gaps of 1 to 4 varint bytes (127, 128, 16383, 16384 and 2^21 apart) from vertex 0
+TEST_CASE(compressed_graph_round_trips_varint_gaps) {
+    generator::Instance instance;
+    std::vector<int> neighbors = {1, 128, 256, 16639, 33023, 33023 + (1 << 21)};
+    instance.num_vertex = neighbors.back() + 1;
+    for (std::size_t i = 0; i < neighbors.size(); i++) {
+        instance.origins.push_back(0);
+        instance.dests.push_back(neighbors[i]);
+        instance.weights.push_back(1.5 + (double) i);
+    }
+
+    CsvFiles files(instance, "varint");
+    UndirectedGraph graph;
+    CHECK(graph.load(files.edges));
+    CompressedGraph compressed(graph);
+    checkRoundTrip(graph, compressed);
+}
+
+TEST_CASE(compressed_graph_round_trips_geographic) {
+    CsvFiles files(generator::geographic(3000, 9, 6), "compressed");
+    UndirectedGraph graph;
+    CHECK(graph.load(files.edges, files.nodes));
+    CompressedGraph compressed(graph);
+    checkRoundTrip(graph, compressed);
+
+    // each edge of a path or tree is off by at most getMaxError
+    std::vector<int> parent, order;
+    double mst = graph.prim(0, parent, order);
+    CHECK(std::abs(compressed.prim(0, parent) - mst) <= compressed.getMaxError() * graph.getNumVertex() + 1e-6);
+}
@@ -0,0 +1,29 @@
+#ifndef FEUP_DA2_CSVFILES_H
+#define FEUP_DA2_CSVFILES_H
+
+#include "Generator.h"
+
+#include <filesystem>
+#include <string>
+
+// Csv files of a generated instance in the temporary directory, removed with the object
+struct CsvFiles {
+    std::string edges;
+    std::string nodes;
+
+    CsvFiles(const generator::Instance &instance, const std::string &name) {
+        std::filesystem::path dir = std::filesystem::temp_directory_path();
+        edges = (dir / ("feup_da2_" + name + "_edges.csv")).string();
+        nodes = instance.hasCoordinates() ? (dir / ("feup_da2_" + name + "_nodes.csv")).string() : "";
+        generator::writeCsv(instance, edges, nodes);
+    }
+
+    ~CsvFiles() {
+        std::filesystem::remove(edges);
+        if (!nodes.empty()) {
+            std::filesystem::remove(nodes);
+        }
+    }
+};
+
+#endif // FEUP_DA2_CSVFILES_H
@@ -0,0 +1,204 @@
+#include "Check.h"
+#include "CompactGraph.h"
+#include "ContractionHierarchy.h"
+#include "Generator.h"
+#include "Graph.h"
+#include "GraphLoader.h"
+
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <vector>
+
+// Distance of every vertex from the last single source search, by id
+static std::vector<double> distances(const Graph &graph) {
+    std::vector<double> dist(graph.getNumVertex());
+    for (int id = 0; id < graph.getNumVertex(); id++) {
+        dist[id] = graph.findVertex(id)->getDistance();
+    }
+    return dist;
+}
+
+// Check delta-stepping against Dijkstra from a few sources, with several bucket widths and thread counts
+static void checkDeltaStepping(const generator::Instance &instance) {
+    Graph graph(instance.hasCoordinates());
+    loader::buildGraph(graph, instance);
+
+    for (int source: {0, instance.num_vertex / 2, instance.num_vertex - 1}) {
+        graph.dijkstra(graph.findVertex(source));
+        std::vector<double> expected = distances(graph);
+
+        for (double delta: {0.0, 1.0, 1e9}) {
+            for (unsigned int threads: {1u, 4u}) {
+                graph.deltaStepping(graph.findVertex(source), delta, threads);
+                std::vector<double> dist = distances(graph);
+                for (int id = 0; id < graph.getNumVertex(); id++) {
+                    CHECK_NEAR(dist[id], expected[id]);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE(delta_stepping_matches_dijkstra_on_geographic) {
+    checkDeltaStepping(generator::geographic(2000, 7, 6));
+}
+
+TEST_CASE(delta_stepping_matches_dijkstra_on_grid) {
+    checkDeltaStepping(generator::grid(1600, 3));
+}
+
+TEST_CASE(delta_stepping_matches_dijkstra_on_complete) {
+    checkDeltaStepping(generator::uniform(150, 11));
+}
+
+// The incomming edges are only built by the first bidirectional search, and rebuilt after the edges change
+TEST_CASE(bidirectional_dijkstra_matches_dijkstra) {
+    generator::Instance instance = generator::geographic(1500, 5, 6);
+    Graph graph(true);
+    loader::buildGraph(graph, instance);
+
+    for (int round = 0; round < 2; round++) {
+        for (int source: {0, instance.num_vertex / 3}) {
+            graph.dijkstra(graph.findVertex(source));
+            std::vector<double> expected = distances(graph);
+            for (int dest = 0; dest < graph.getNumVertex(); dest += 37) {
+                double d = graph.bidirectionalDijkstra(graph.findVertex(source), graph.findVertex(dest));
+                CHECK_NEAR(d, dest == source ? 0 : expected[dest]);
+            }
+        }
+        // a shortcut from the first source, so the second round uses edges added after the first search
+        graph.addEdge(0, instance.num_vertex - 1, 1e-3);
+    }
+}
+
+TEST_CASE(a_star_matches_dijkstra) {
+    generator::Instance instance = generator::geographic(1500, 9, 6);
+    Graph graph(true);
+    loader::buildGraph(graph, instance);
+
+    for (int source: {0, instance.num_vertex / 2}) {
+        graph.dijkstra(graph.findVertex(source));
+        std::vector<double> expected = distances(graph);
+        for (int dest = 0; dest < graph.getNumVertex(); dest += 31) {
+            unsigned int settled;
+            double d = graph.aStar(graph.findVertex(source), graph.findVertex(dest), &settled);
+            CHECK_NEAR(d, dest == source ? 0 : expected[dest]);
+            CHECK((int) settled <= graph.getNumVertex());
+        }
+    }
+}
+
+TEST_CASE(point_to_point_queries_after_removing_a_vertex) {
+    generator::Instance instance = generator::geographic(400, 13, 6);
+    Graph graph(true);
+    loader::buildGraph(graph, instance);
+    // ids stop being dense, the last ones are at least the number of vertexes
+    graph.removeVertex(1);
+    graph.removeVertex(2);
+
+    int last = instance.num_vertex - 1;
+    graph.dijkstra(graph.findVertex(last));
+    for (int dest = 0; dest < instance.num_vertex; dest += 7) {
+        Vertex* v = graph.findVertex(dest);
+        if (v == nullptr) {
+            continue;
+        }
+        double expected = dest == last ? 0 : v->getDistance();
+        CHECK_NEAR(graph.bidirectionalDijkstra(graph.findVertex(last), v), expected);
+        CHECK_NEAR(graph.aStar(graph.findVertex(last), v), expected);
+    }
+}
+
+// The radix heap needs integer weights, so Dijkstra runs on the same instance with its weights rounded
+static void checkRadixHeapDijkstra(generator::Instance instance) {
+    for (double &w: instance.weights) {
+        w = std::round(w * 100);
+    }
+    Graph graph(instance.hasCoordinates());
+    loader::buildGraph(graph, instance);
+    BasicCompactGraph<int32_t> compact(graph);
+
+    for (int source: {0, instance.num_vertex / 2, instance.num_vertex - 1}) {
+        graph.dijkstra(graph.findVertex(source));
+        std::vector<double> expected = distances(graph);
+        std::vector<int64_t> dist = radixHeapDijkstra(compact, source);
+        for (int id = 0; id < graph.getNumVertex(); id++) {
+            if (expected[id] == std::numeric_limits<double>::max()) {
+                CHECK(dist[id] == std::numeric_limits<int64_t>::max());
+            } else {
+                CHECK(dist[id] == (int64_t) expected[id]);
+            }
+        }
+    }
+}
+
+TEST_CASE(radix_heap_dijkstra_matches_dijkstra_on_geographic) {
+    checkRadixHeapDijkstra(generator::geographic(2000, 7, 6));
+}
+
+TEST_CASE(radix_heap_dijkstra_matches_dijkstra_on_complete) {
+    checkRadixHeapDijkstra(generator::uniform(150, 11));
+}
+
+TEST_CASE(contraction_hierarchy_tables_match_dijkstra) {
+    generator::Instance instance = generator::geographic(800, 17, 6);
+    Graph graph(true);
+    loader::buildGraph(graph, instance);
+    ContractionHierarchy hierarchy(graph);
+
+    std::vector<int> sources = {0, 5, instance.num_vertex / 2}, targets;
+    for (int v = 0; v < instance.num_vertex; v += 23) {
+        targets.push_back(v);
+    }
+    std::vector<std::vector<double>> table = hierarchy.manyToMany(sources, targets);
+    DistanceMatrix square = hierarchy.distanceTable(sources);
+    for (std::size_t i = 0; i < sources.size(); i++) {
+        graph.dijkstra(graph.findVertex(sources[i]));
+        std::vector<double> expected = distances(graph);
+        expected[sources[i]] = 0;
+        for (std::size_t j = 0; j < targets.size(); j++) {
+            CHECK_NEAR(table[i][j], expected[targets[j]]);
+        }
+        for (std::size_t j = 0; j < sources.size(); j++) {
+            CHECK_NEAR(square(i, j), expected[sources[j]]);
+        }
+    }
+}
+
+TEST_CASE(contraction_hierarchy_queries_match_dijkstra_and_survive_save_load) {
+    generator::Instance instance = generator::geographic(800, 19, 6);
+    Graph graph(true);
+    loader::buildGraph(graph, instance);
+    CHECK(ContractionHierarchy::isSparse(graph));
+    ContractionHierarchy hierarchy(graph);
+
+    std::string path = (std::filesystem::temp_directory_path() / "feup_da2_test_hierarchy.ch").string();
+    CHECK(hierarchy.save(path));
+    ContractionHierarchy loaded;
+    CHECK(loaded.load(path));
+    std::filesystem::remove(path);
+    CHECK(loaded.getNumVertex() == hierarchy.getNumVertex());
+    CHECK(loaded.getNumEdges() == hierarchy.getNumEdges());
+    CHECK(loaded.getFingerprint() == ContractionHierarchy::fingerprint(graph));
+
+    for (int source: {0, instance.num_vertex / 3, instance.num_vertex - 1}) {
+        graph.dijkstra(graph.findVertex(source));
+        std::vector<double> expected = distances(graph);
+        for (int dest = 0; dest < instance.num_vertex; dest += 11) {
+            double d = dest == source ? 0 : expected[dest];
+            CHECK_NEAR(hierarchy.query(source, dest), d);
+            CHECK_NEAR(loaded.query(source, dest), d);
+        }
+    }
+}
+
+TEST_CASE(contraction_hierarchy_refuses_dense_graphs) {
+    Graph graph(false);
+    loader::buildGraph(graph, generator::uniform(60, 5));
+    CHECK(!ContractionHierarchy::isSparse(graph));
+
+    Graph sparse(true);
+    loader::buildGraph(sparse, generator::geographic(100, 5, 6));
+    CHECK(ContractionHierarchy::isSparse(sparse));
+}
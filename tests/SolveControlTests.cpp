@@ -0,0 +1,33 @@
+#include "Check.h"
+#include "SolveControl.h"
+
+TEST_CASE(poll_keeps_the_work_of_each_control_apart) {
+    SolveControl first, second;
+    for (int i = 0; i < 10; i++) {
+        first.poll(1);
+    }
+    // interleaved on the same thread, the batch of first must not be published to second
+    second.poll(2);
+    second.flush();
+    CHECK(second.getWork() == 2);
+
+    for (int i = 0; i < 10; i++) {
+        first.poll(1);
+    }
+    first.flush();
+    // the first poll of each batch publishes at once, the 9 left of the first batch were dropped by the switch
+    CHECK(first.getWork() == 11);
+
+    // after a flush nothing is left to publish
+    first.flush();
+    CHECK(first.getWork() == 11);
+}
+
+TEST_CASE(flush_publishes_the_batched_work) {
+    SolveControl control;
+    for (int i = 0; i < 100; i++) {
+        CHECK(!control.poll(1));
+    }
+    control.flush();
+    CHECK(control.getWork() == 100);
+}
@@ -0,0 +1,54 @@
+#include "Check.h"
+#include "Graph.h"
+#include "SolveService.h"
+
+#include <limits>
+
+// Two components, 0-1 and 2-3, so no tour visits every vertex
+static void buildDisconnected(Graph &graph) {
+    for (int id = 0; id < 4; id++) {
+        graph.addVertex(id);
+    }
+    graph.addBidirectionalEdge(0, 1, 1);
+    graph.addBidirectionalEdge(2, 3, 1);
+    graph.sortAdjacency();
+}
+
+TEST_CASE(service_bruteforce_is_not_optimal_without_a_tour) {
+    Graph graph(false);
+    buildDisconnected(graph);
+    SolveService service(graph, 1);
+
+    SolveService::Request request;
+    request.algorithm = "bruteforce";
+    SolveService::Result result = service.submit(request).get();
+    CHECK(result.error.empty());
+    CHECK(result.cost == std::numeric_limits<double>::infinity());
+    CHECK(!result.optimal);
+
+    request.vertexes = {0, 1};
+    result = service.submit(request).get();
+    CHECK(result.error.empty());
+    CHECK_NEAR(result.cost, 2);
+    CHECK(result.optimal);
+}
+
+TEST_CASE(service_refuses_matrices_above_the_limit) {
+    Graph graph(false);
+    buildDisconnected(graph);
+    graph.setDenseMatrixLimit(2 * 2 * sizeof(double));
+    SolveService service(graph, 1);
+
+    SolveService::Request request;
+    request.algorithm = "annealing";
+    request.time_limit = 0.01;
+    CHECK(!service.submit(request).get().error.empty());
+
+    request.vertexes = {0, 1};
+    SolveService::Result result = service.submit(request).get();
+    CHECK(result.error.empty());
+    CHECK(result.tour.size() == 3);
+
+    CHECK(SolveService::supports("ils"));
+    CHECK(!SolveService::supports("triangular"));
+}
@@ -0,0 +1,107 @@
+#include "Check.h"
+#include "DistanceMatrix.h"
+#include "Generator.h"
+#include "Graph.h"
+#include "GraphLoader.h"
+#include "LocalSearch.h"
+#include "SolveControl.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// Small geographic instance every solver runs on (sparse, the missing edges cost their haversine distance)
+static void buildInstance(Graph &graph) {
+    loader::buildGraph(graph, generator::geographic(200, 11, 6));
+}
+
+// Check a tour is a cycle through every vertex from vertex 0, of the cost returned and no worse than the nearest
+// neighbor tour over the same distances
+static void checkTour(const Graph &graph, const std::vector<Vertex *> &tsp_path, double cost) {
+    int n = graph.getNumVertex();
+    CHECK((int) tsp_path.size() == n + 1);
+    if ((int) tsp_path.size() != n + 1) {
+        return;
+    }
+    CHECK(tsp_path.front()->getId() == 0);
+    CHECK(tsp_path.back()->getId() == 0);
+
+    DistanceMatrix dist(graph);
+    std::vector<bool> seen(n, false);
+    double path_cost = 0;
+    for (int i = 0; i < n; i++) {
+        int id = tsp_path[i]->getId();
+        CHECK(!seen[id]);
+        seen[id] = true;
+        path_cost += dist(id, tsp_path[i + 1]->getId());
+    }
+    CHECK_NEAR(cost, path_cost);
+
+    double nearest_neighbor_cost = dist.tourCost(localsearch::nearestNeighborTour(dist, 0));
+    CHECK(cost <= nearest_neighbor_cost * (1 + 1e-9));
+}
+
+TEST_CASE(hilbert_curve_tour_is_valid) {
+    Graph graph(true);
+    buildInstance(graph);
+    std::vector<Vertex *> tsp_path;
+    double cost = graph.tspHilbertCurve(tsp_path, true);
+    checkTour(graph, tsp_path, cost);
+}
+
+TEST_CASE(insertion_tours_are_valid) {
+    Graph graph(true);
+    buildInstance(graph);
+    std::vector<Vertex *> tsp_path;
+    double cost = graph.tspCheapestInsertion(tsp_path);
+    checkTour(graph, tsp_path, cost);
+    cost = graph.tspFarthestInsertion(tsp_path);
+    checkTour(graph, tsp_path, cost);
+}
+
+TEST_CASE(iterated_local_search_tour_is_valid) {
+    Graph graph(true);
+    buildInstance(graph);
+    std::vector<Vertex *> tsp_path;
+    double cost = graph.tspIteratedLocalSearch(tsp_path, 0.05, 2);
+    checkTour(graph, tsp_path, cost);
+}
+
+TEST_CASE(simulated_annealing_tour_is_valid) {
+    Graph graph(true);
+    buildInstance(graph);
+    std::vector<Vertex *> tsp_path;
+    double moves_per_second;
+    double cost = graph.tspSimulatedAnnealing(tsp_path, 0.05, 2, moves_per_second);
+    checkTour(graph, tsp_path, cost);
+    CHECK(moves_per_second > 0);
+}
+
+TEST_CASE(cluster_decomposition_tour_is_valid) {
+    Graph graph(true);
+    buildInstance(graph);
+    std::vector<Vertex *> tsp_path;
+    // several clusters, so the junctions between their tours are part of the check
+    double cost = graph.tspClusterDecomposition(tsp_path, 50, 2);
+    checkTour(graph, tsp_path, cost);
+}
+
+TEST_CASE(bruteforce_without_a_tour_costs_infinity) {
+    Graph graph(false);
+    loader::buildGraph(graph, generator::uniform(9, 3));
+    std::vector<Vertex *> tsp_path;
+
+    // stopped before the first leaf, like a batch job past its deadline
+    SolveControl control;
+    control.cancel();
+    double cost = graph.tspBruteforce(tsp_path, &control);
+    CHECK(tsp_path.empty());
+    CHECK(cost == std::numeric_limits<double>::infinity());
+    CHECK(!control.isOptimal());
+
+    SolveControl unlimited;
+    cost = graph.tspBruteforce(tsp_path, &unlimited);
+    CHECK(std::isfinite(cost));
+    CHECK(unlimited.isOptimal());
+    checkTour(graph, tsp_path, cost);
+}
@@ -0,0 +1,84 @@
+#include "Check.h"
+#include "CompactGraph.h"
+#include "DistanceMatrix.h"
+#include "Generator.h"
+#include "Graph.h"
+#include "GraphLoader.h"
+#include "TiledDistanceMatrix.h"
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static std::string tempPath(const std::string &name) {
+    return (std::filesystem::temp_directory_path() / ("feup_da2_" + name + ".tiles")).string();
+}
+
+// Every distance read through the tiles (with a cache small enough to evict) must match the dense matrix
+static void checkTiledMatrix(const generator::Instance &instance, const std::string &name) {
+    Graph graph(instance.hasCoordinates());
+    loader::buildGraph(graph, instance);
+    CompactGraph compact(graph);
+    DistanceMatrix expected(compact);
+
+    std::string path = tempPath(name);
+    CHECK(TiledDistanceMatrix::create(path, compact, 32));
+    TiledDistanceMatrix tiled;
+    CHECK(tiled.open(path, 3));
+    CHECK(tiled.size() == expected.size());
+
+    for (std::size_t i = 0; i < tiled.size(); i++) {
+        for (std::size_t j = 0; j < tiled.size(); j++) {
+            if (i != j) {
+                CHECK(tiled(i, j) == (double) (float) expected(i, j));
+            }
+        }
+    }
+    tiled.close();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE(tiled_matrix_matches_dense_on_geographic) {
+    checkTiledMatrix(generator::geographic(300, 4, 6), "geographic");
+}
+
+TEST_CASE(tiled_matrix_matches_dense_on_sparse) {
+    checkTiledMatrix(generator::uniform(100, 8, 5), "sparse");
+}
+
+TEST_CASE(tiled_matrix_open_rejects_other_files) {
+    std::string path = tempPath("invalid");
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "not a tiled matrix";
+    }
+    TiledDistanceMatrix tiled;
+    CHECK(!tiled.open(path));
+    CHECK(!tiled.open(tempPath("missing")));
+    std::filesystem::remove(path);
+}
+
+// With no room for a dense matrix, ILS and annealing run on the tiled one and still return complete tours
+TEST_CASE(solvers_fall_back_to_tiled_matrix) {
+    Graph graph(true);
+    loader::buildGraph(graph, generator::geographic(200, 6, 6));
+    graph.setDenseMatrixLimit(0);
+    CHECK(!graph.fitsDenseMatrix());
+
+    std::vector<Vertex *> tsp_path;
+    double cost = graph.tspIteratedLocalSearch(tsp_path, 0.05, 2);
+    CHECK((int) tsp_path.size() == graph.getNumVertex() + 1);
+    CHECK(std::isfinite(cost) && cost > 0);
+
+    double moves_per_second;
+    cost = graph.tspSimulatedAnnealing(tsp_path, 0.05, 2, moves_per_second);
+    CHECK((int) tsp_path.size() == graph.getNumVertex() + 1);
+    CHECK(std::isfinite(cost) && cost > 0);
+
+    double curve_cost = graph.tspHilbertCurve(tsp_path, false);
+    cost = graph.tspHilbertCurve(tsp_path, true);
+    CHECK((int) tsp_path.size() == graph.getNumVertex() + 1);
+    CHECK(std::isfinite(cost) && cost <= curve_cost);
+}
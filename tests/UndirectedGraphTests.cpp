@@ -0,0 +1,165 @@
+#include "Check.h"
+#include "CsvFiles.h"
+#include "Generator.h"
+#include "Graph.h"
+#include "GraphLoader.h"
+#include "UndirectedGraph.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Load the same files as a Graph and an UndirectedGraph and compare their distances, MST and triangular tour
+static void checkUndirectedGraph(const generator::Instance &instance, const std::string &name) {
+    CsvFiles files(instance, name);
+    UndirectedGraph undirected;
+    CHECK(undirected.load(files.edges, files.nodes));
+    Graph graph(!files.nodes.empty());
+    CHECK(loader::readGraph(graph, files.edges, files.nodes));
+
+    int n = undirected.getNumVertex();
+    CHECK(n == graph.getNumVertex());
+    CHECK(undirected.getNumEdges() == instance.getNumEdges());
+    CHECK(undirected.hasCoordinates() == instance.hasCoordinates());
+
+    for (int u = 0; u < n; u += 7) {
+        for (int v = 1; v < n; v += 13) {
+            if (u != v) {
+                CHECK_NEAR(undirected.findDistance(u, v), graph.findDistance(graph.findVertex(u), graph.findVertex(v)));
+            }
+        }
+    }
+
+    // Graph::prim leaves the tree edge of each vertex in its path
+    std::vector<Vertex *> preorder;
+    double preorder_cost = 0;
+    graph.prim(graph.findVertex(0), preorder, preorder_cost);
+    double mst_cost = 0;
+    for (auto v: graph.getVertexSet()) {
+        if (v.second->getPath() != nullptr) {
+            mst_cost += v.second->getPath()->getWeight();
+        }
+    }
+    std::vector<int> parent, order;
+    CHECK_NEAR(undirected.prim(0, parent, order), mst_cost);
+    CHECK((int) order.size() == n);
+
+    std::vector<int> tour;
+    double cost = undirected.triangularApproximation(tour);
+    CHECK((int) tour.size() == n);
+    CHECK(!tour.empty() && tour[0] == 0);
+    std::vector<int> sorted = tour;
+    std::sort(sorted.begin(), sorted.end());
+    CHECK(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+    double expected = 0;
+    for (std::size_t i = 0; i < tour.size(); i++) {
+        expected += undirected.findDistance(tour[i], tour[(i + 1) % tour.size()]);
+    }
+    CHECK_NEAR(cost, expected);
+}
+
+TEST_CASE(undirected_graph_matches_graph_on_geographic) {
+    checkUndirectedGraph(generator::geographic(1000, 3, 6), "geographic");
+}
+
+TEST_CASE(undirected_graph_matches_graph_on_complete) {
+    checkUndirectedGraph(generator::uniform(120, 5), "complete");
+}
+
+TEST_CASE(undirected_graph_load_fails_on_missing_file) {
+    UndirectedGraph graph;
+    CHECK(!graph.load("/nonexistent/edges.csv"));
+}
+
+// Both walk the MST children in the order they joined the tree (distinct weights, so the tree has no ties)
+TEST_CASE(undirected_triangular_matches_graph_triangular) {
+    CsvFiles files(generator::uniform(150, 21), "triangular");
+    UndirectedGraph undirected;
+    CHECK(undirected.load(files.edges));
+    Graph graph;
+    CHECK(loader::readGraph(graph, files.edges));
+
+    std::vector<int> tour;
+    undirected.triangularApproximation(tour);
+    std::vector<Vertex *> tsp_path;
+    graph.triangularApproximation(tsp_path);
+    CHECK(tsp_path.size() == tour.size() + 1);
+    for (std::size_t i = 0; i < tour.size() && i < tsp_path.size(); i++) {
+        CHECK(tsp_path[i]->getId() == tour[i]);
+    }
+}
+
+// Edges added out of order are found before and after the lists are sorted, and removing one keeps the rest
+TEST_CASE(adjacency_lookup_before_and_after_sorting) {
+    Graph graph;
+    for (int id = 0; id < 6; id++) {
+        graph.addVertex(id);
+    }
+    for (int dest: {4, 1, 5, 2}) {
+        graph.addBidirectionalEdge(0, dest, dest * 1.5);
+    }
+
+    Vertex* v = graph.findVertex(0);
+    for (int pass = 0; pass < 2; pass++) {
+        for (int dest: {1, 2, 4, 5}) {
+            CHECK(v->getEdge(dest) != nullptr && v->getEdge(dest)->getWeight() == dest * 1.5);
+            CHECK(v->getEdge(dest)->getReverse() == graph.findVertex(dest)->getEdge(0));
+        }
+        CHECK(v->getEdge(3) == nullptr);
+        graph.sortAdjacency();
+    }
+
+    std::vector<Edge *> adj = v->getAdj();
+    for (std::size_t i = 0; i + 1 < adj.size(); i++) {
+        CHECK(adj[i]->getDest()->getId() < adj[i + 1]->getDest()->getId());
+    }
+    CHECK(v->removeEdge(4));
+    CHECK(v->getEdge(4) == nullptr && v->getEdge(5) != nullptr);
+    CHECK(graph.findVertex(4)->getEdge(0)->getReverse() == nullptr);
+
+    // flow and an explicit reverse live in the cold part of the origin, every other edge reads the defaults
+    Edge* edge = v->getEdge(5);
+    Edge* other = v->getEdge(2);
+    edge->setFlow(2.5);
+    edge->setReverse(other);
+    CHECK(edge->getFlow() == 2.5 && edge->getReverse() == other);
+    CHECK(v->getEdge(1)->getFlow() == 0);
+    edge->setReverse(nullptr);
+    CHECK(edge->getReverse() == graph.findVertex(5)->getEdge(0) && edge->getFlow() == 2.5);
+    CHECK(v->removeEdge(5));
+    CHECK(v->getEdge(2)->getFlow() == 0);
+}
+
+// A field that is not a number (or does not fit an int) fails the load instead of throwing
+TEST_CASE(loaders_reject_malformed_fields) {
+    std::string path = (std::filesystem::temp_directory_path() / "feup_da2_malformed_edges.csv").string();
+    for (const char* row: {"0,1,abc", "0,x,1.5", "0,99999999999,1.5", "-1,2,1.5"}) {
+        {
+            std::ofstream file(path);
+            file << "origin,destination,distance\n0,2,3.5\n" << row << '\n';
+        }
+
+        UndirectedGraph undirected;
+        CHECK(!undirected.load(path));
+        CHECK(undirected.getNumVertex() == 0);
+        if (std::string(row)[0] != '-') {
+            Graph graph;
+            CHECK(!loader::readGraph(graph, path));
+        }
+    }
+
+    // blank lines (a trailing one in particular) are skipped, not parsed as fields
+    {
+        std::ofstream file(path);
+        file << "origin,destination,distance\n0,2,3.5\n\n1,2,1.5\n  \r\n\n";
+    }
+    UndirectedGraph undirected;
+    CHECK(undirected.load(path));
+    CHECK(undirected.getNumVertex() == 3 && undirected.getNumEdges() == 2);
+    Graph graph;
+    CHECK(loader::readGraph(graph, path));
+    CHECK(graph.getNumVertex() == 3);
+    std::filesystem::remove(path);
+}